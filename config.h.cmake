@@ -41,6 +41,21 @@
 # define DUNE_STUFF_DO_PROFILE 0
 #endif
 
+/* needed in dune/stuff/common/profiler.cc, replaces the global operator new and delete to count allocations */
+#ifndef DUNE_STUFF_PROFILE_ALLOCATIONS
+# define DUNE_STUFF_PROFILE_ALLOCATIONS 0
+#endif
+
+/* needed in dune/stuff/la/container/kernels.cc, the results of the reductions depend on this number (a power of two) */
+#ifndef DUNE_STUFF_LA_KERNEL_ACCUMULATORS
+# define DUNE_STUFF_LA_KERNEL_ACCUMULATORS 16
+#endif
+
+/* needed in dune/stuff/la/container/vector-interface-internal.hh, vectors of at least this size are processed by all threads */
+#ifndef DUNE_STUFF_LA_PARALLEL_THRESHOLD
+# define DUNE_STUFF_LA_PARALLEL_THRESHOLD 131072
+#endif
+
 /*** Silence implicitly False evaluation of undefined macro warnings ****/
 #ifndef HAVE_DUNE_FEM
 # define HAVE_FUNE_FEM 0
@@ -0,0 +1,223 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "config.h"
+
+#include <boost/format.hpp>
+
+#include <dune/common/unused.hh>
+
+#include "exceptions.hh"
+#include "string.hh"
+#include "logstreams.hh"
+#include "binarylogging.hh"
+
+namespace Dune {
+namespace Stuff {
+namespace Common {
+namespace {
+
+
+const char magic[8] = {'D', 'S', 'C', 'B', 'L', 'O', 'G', '\0'};
+const std::uint32_t version = 1;
+//! written in native byte order to detect logs from machines of different endianness
+const std::uint32_t byte_order = 0x01020304;
+
+template< class T >
+bool read(std::istream& in, T& value)
+{
+  return bool(in.read(reinterpret_cast< char* >(&value), sizeof(T)));
+}
+
+bool read_string(std::istream& in, std::string& str)
+{
+  std::uint32_t size;
+  if (!read(in, size))
+    return false;
+  str.resize(size);
+  return size == 0 || bool(in.read(&str[0], size));
+}
+
+//! the default ids of TimedLogging for the levels
+std::string level_name(const std::uint8_t level)
+{
+  switch (level) {
+    case BinaryLogging::info:
+      return "info";
+    case BinaryLogging::debug:
+      return "debug";
+    case BinaryLogging::warn:
+      return "warn";
+    default:
+      return "level " + toString(int(level));
+  }
+} // ... level_name(...)
+
+
+} // namespace
+
+
+constexpr BinaryLogging::IdType BinaryLogging::unknown_id;
+
+BinaryLogging::BinaryLogging()
+  : enabled_(false)
+  , begin_(0)
+  , file_buffer_(1 << 20)
+{}
+
+BinaryLogging::~BinaryLogging()
+{
+  close();
+}
+
+void BinaryLogging::create(const std::string filename)
+{
+  close();
+  std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+  file_.rdbuf()->pubsetbuf(file_buffer_.data(), file_buffer_.size());
+  file_.open(filename, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open())
+    DUNE_THROW(Exceptions::wrong_input_given, "could not open '" << filename << "' for writing!");
+  file_.write(magic, sizeof(magic));
+  file_.write(reinterpret_cast< const char* >(&version), sizeof(version));
+  file_.write(reinterpret_cast< const char* >(&byte_order), sizeof(byte_order));
+  for (IdType ii = 0; ii < strings_.size(); ++ii)
+    write_definition(ii);
+  begin_.store(nanoseconds(ClockType::now()), std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_release);
+} // ... create(...)
+
+void BinaryLogging::close()
+{
+  std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+  enabled_ = false;
+  if (file_.is_open())
+    file_.close();
+}
+
+BinaryLogging::IdType BinaryLogging::id(const std::string& str)
+{
+  std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+  const auto it = ids_.find(str);
+  if (it != ids_.end())
+    return it->second;
+  const auto ret = IdType(strings_.size());
+  ids_[str] = ret;
+  strings_.push_back(str);
+  if (file_.is_open())
+    write_definition(ret);
+  return ret;
+} // ... id(...)
+
+void BinaryLogging::flush()
+{
+  std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+  if (file_.is_open())
+    file_.flush();
+}
+
+void BinaryLogging::write(const std::string& record)
+{
+  std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+  if (file_.is_open())
+    file_.write(record.data(), record.size());
+}
+
+void BinaryLogging::write_definition(const IdType id)
+{
+  std::string record;
+  append(record, std::uint8_t(definition_record));
+  append(record, id);
+  append_string(record, strings_[id].data(), strings_[id].size());
+  file_.write(record.data(), record.size());
+}
+
+void BinaryLogging::decode(std::istream& in, std::ostream& out)
+{
+  char header[sizeof(magic)];
+  std::uint32_t file_version, file_byte_order;
+  if (!in.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic))
+    DUNE_THROW(Exceptions::wrong_input_given, "this is not a binary log!");
+  if (!read(in, file_version) || file_version != version)
+    DUNE_THROW(Exceptions::wrong_input_given, "unsupported binary log version " << file_version << "!");
+  if (!read(in, file_byte_order) || file_byte_order != byte_order)
+    DUNE_THROW(Exceptions::wrong_input_given, "the binary log was written on a machine of different byte order!");
+  std::map< IdType, std::string > strings;
+  const auto string = [&](const IdType id) -> const std::string& {
+    const auto it = strings.find(id);
+    if (it == strings.end())
+      DUNE_THROW(Exceptions::wrong_input_given, "the binary log is corrupt, unknown id " << id << "!");
+    return it->second;
+  };
+  // a log that has not been closed properly may end within a record, that record is skipped
+  std::uint8_t record_type;
+  while (read(in, record_type)) {
+    if (record_type == definition_record) {
+      IdType id;
+      std::string str;
+      if (!read(in, id) || !read_string(in, str))
+        break;
+      strings[id] = str;
+    } else if (record_type == message_record) {
+      std::int64_t elapsed;
+      IdType logger, format;
+      std::uint8_t level, num_arguments;
+      if (!read(in, elapsed) || !read(in, logger) || !read(in, level) || !read(in, format) || !read(in, num_arguments))
+        break;
+      boost::format message(string(format));
+      message.exceptions(boost::io::no_error_bits);
+      bool complete = true;
+      for (std::uint8_t ii = 0; complete && ii < num_arguments; ++ii) {
+        std::uint8_t argument_type;
+        complete = read(in, argument_type);
+        if (!complete)
+          break;
+        if (argument_type == signed_argument) {
+          std::int64_t value;
+          complete = read(in, value);
+          message % value;
+        } else if (argument_type == unsigned_argument) {
+          std::uint64_t value;
+          complete = read(in, value);
+          message % value;
+        } else if (argument_type == floating_point_argument) {
+          double value;
+          complete = read(in, value);
+          message % value;
+        } else if (argument_type == string_argument) {
+          std::string value;
+          complete = read_string(in, value);
+          message % value;
+        } else
+          DUNE_THROW(Exceptions::wrong_input_given,
+                     "the binary log is corrupt, unknown argument type " << int(argument_type) << "!");
+      }
+      if (!complete)
+        break;
+      // like TimedLogging, the level takes the place of an empty logger id
+      const auto& logger_id = string(logger);
+      const std::string prefix = elapsed_time_str(double(elapsed) * 1e-9)
+                               + (logger_id.empty() ? level_name(level) : logger_id + "[" + level_name(level) + "]")
+                               + ": ";
+      for (const auto& line : tokenize(message.str(), "\n", boost::algorithm::token_compress_off))
+        out << prefix << line << "\n";
+    } else
+      DUNE_THROW(Exceptions::wrong_input_given,
+                 "the binary log is corrupt, unknown record type " << int(record_type) << "!");
+  }
+  out.flush();
+} // ... decode(...)
+
+
+BinaryLogging& BinaryLogger()
+{
+  static BinaryLogging binary_logger;
+  return binary_logger;
+}
+
+
+} // namespace Common
+} // namespace Stuff
+} // namespace Dune
@@ -0,0 +1,273 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_COMMON_BINARYLOGGING_HH
+#define DUNE_STUFF_COMMON_BINARYLOGGING_HH
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+namespace Dune {
+namespace Stuff {
+namespace Common {
+
+/**
+ * \brief A logger that writes structured binary records instead of formatted text.
+ *
+ *        Each record holds the time elapsed since create(), the id of the logger, a level, the id of a
+ *        boost::format string and the raw arguments. Arithmetic arguments and strings are stored as they are, all
+ *        other arguments are converted to strings using operator<<. Logger and format strings are written to the file
+ *        only once. Use decode() (or the dune-stuff-decode-binary-log program) to turn a binary log into the format of
+ *        TimedPrefixedLogStream, with the level appended to the logger id, e.g.
+\code
+BinaryLogger().create("convergence.blog");
+for (size_t ii = 0; ii < 1000000; ++ii)
+  DSC_BINARY_LOG_INFO("study", "iteration %d: error %e", ii, error);
+\endcode
+ *        gives after decoding:
+\code
+00:00|study[info]: iteration 0: error 1.0e-01
+...
+\endcode
+ * \note  Most likely you do not want to use this class directly but the DSC_BINARY_LOG_* macros instead.
+ */
+class BinaryLogging
+{
+  typedef std::chrono::steady_clock ClockType;
+
+public:
+  typedef std::uint32_t IdType;
+
+  //! never returned by id(), marks an id that has not been looked up yet
+  static constexpr IdType unknown_id = std::numeric_limits< IdType >::max();
+
+  enum Level : std::uint8_t
+  {
+    info = 0,
+    debug = 1,
+    warn = 2
+  };
+
+  BinaryLogging();
+
+  ~BinaryLogging();
+
+  /**
+   * \brief opens filename, all logging before is discarded
+   * \note  Closes the current file, if any.
+   */
+  void create(const std::string filename);
+
+  //! writes all records and closes the file, all logging afterwards is discarded
+  void close();
+
+  bool enabled() const
+  {
+    // pairs with the release in create(), so a thread seeing enabled_ also sees begin_
+    return enabled_.load(std::memory_order_acquire);
+  }
+
+  //! \return the id of str, which may be a logger id or a format string
+  IdType id(const std::string& str);
+
+  template< class... Args >
+  void log(const IdType logger, const Level level, const IdType format, const Args&... args)
+  {
+    if (!enabled())
+      return;
+    static thread_local std::string record;
+    record.clear();
+    const std::int64_t elapsed = nanoseconds(ClockType::now()) - begin_.load(std::memory_order_relaxed);
+    append(record, std::uint8_t(message_record));
+    append(record, elapsed);
+    append(record, logger);
+    append(record, std::uint8_t(level));
+    append(record, format);
+    append(record, std::uint8_t(sizeof...(Args)));
+    append_arguments(record, args...);
+    write(record);
+  } // ... log(...)
+
+  /**
+   * \brief logs format and args, the id of format is looked up on the first call and stored in format_id
+   * \note  format_id is shared by all threads logging at the same call site, see DSC_BINARY_LOG.
+   */
+  template< class... Args >
+  void log(const IdType logger, const Level level, std::atomic< IdType >& format_id, const char* format,
+           const Args&... args)
+  {
+    if (!enabled())
+      return;
+    auto format_id_value = format_id.load(std::memory_order_relaxed);
+    if (format_id_value == unknown_id) {
+      // threads racing here look up the same id
+      format_id_value = id(format);
+      format_id.store(format_id_value, std::memory_order_relaxed);
+    }
+    log(logger, level, format_id_value, args...);
+  } // ... log(...)
+
+  //! writes all records to the file
+  void flush();
+
+  //! turns the binary log read from in into the format of TimedPrefixedLogStream
+  static void decode(std::istream& in, std::ostream& out);
+
+private:
+  enum RecordType : std::uint8_t
+  {
+    definition_record = 0,
+    message_record = 1
+  };
+
+  enum ArgumentType : std::uint8_t
+  {
+    signed_argument = 0,
+    unsigned_argument = 1,
+    floating_point_argument = 2,
+    string_argument = 3
+  };
+
+  static std::int64_t nanoseconds(const ClockType::time_point time)
+  {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(time.time_since_epoch()).count();
+  }
+
+  template< class T >
+  static void append(std::string& record, const T& value)
+  {
+    static_assert(std::is_arithmetic< T >::value, "");
+    record.append(reinterpret_cast< const char* >(&value), sizeof(T));
+  }
+
+  static void append_string(std::string& record, const char* str, const std::size_t size)
+  {
+    append(record, std::uint32_t(size));
+    record.append(str, size);
+  }
+
+  template< class T >
+  static typename std::enable_if< std::is_floating_point< T >::value >::type
+  append_argument(std::string& record, const T& value)
+  {
+    append(record, std::uint8_t(floating_point_argument));
+    append(record, double(value));
+  }
+
+  template< class T >
+  static typename std::enable_if< std::is_integral< T >::value && std::is_signed< T >::value >::type
+  append_argument(std::string& record, const T& value)
+  {
+    append(record, std::uint8_t(signed_argument));
+    append(record, std::int64_t(value));
+  }
+
+  template< class T >
+  static typename std::enable_if< std::is_integral< T >::value && !std::is_signed< T >::value >::type
+  append_argument(std::string& record, const T& value)
+  {
+    append(record, std::uint8_t(unsigned_argument));
+    append(record, std::uint64_t(value));
+  }
+
+  template< class T >
+  static typename std::enable_if< !std::is_arithmetic< T >::value >::type
+  append_argument(std::string& record, const T& value)
+  {
+    std::ostringstream str;
+    str << value;
+    append_argument(record, str.str());
+  }
+
+  static void append_argument(std::string& record, const std::string& value)
+  {
+    append(record, std::uint8_t(string_argument));
+    append_string(record, value.data(), value.size());
+  }
+
+  static void append_argument(std::string& record, const char* value)
+  {
+    append(record, std::uint8_t(string_argument));
+    append_string(record, value, std::strlen(value));
+  }
+
+  static void append_argument(std::string& record, const char value)
+  {
+    append(record, std::uint8_t(string_argument));
+    append_string(record, &value, 1);
+  }
+
+  static void append_arguments(std::string& /*record*/)
+  {}
+
+  template< class T, class... Args >
+  static void append_arguments(std::string& record, const T& value, const Args&... args)
+  {
+    append_argument(record, value);
+    append_arguments(record, args...);
+  }
+
+  void write(const std::string& record);
+  void write_definition(const IdType id);
+
+  BinaryLogging(const BinaryLogging&) = delete;
+
+  std::atomic< bool > enabled_;
+  //! nanoseconds since the epoch of ClockType at create(), atomic since log() may read it while create() is called
+  std::atomic< std::int64_t > begin_;
+  std::map< std::string, IdType > ids_;
+  std::vector< std::string > strings_;
+  std::vector< char > file_buffer_;
+  std::ofstream file_;
+  std::mutex mutex_;
+}; // class BinaryLogging
+
+
+//! global instance of the binary logger, disabled until BinaryLogging::create() is called
+BinaryLogging& BinaryLogger();
+
+
+} // namespace Common
+} // namespace Stuff
+} // namespace Dune
+
+/**
+ * \name Logging to BinaryLogger(), logger_id and format have to be string literals (or at least stay the same for each
+ *       call site), the ids of both are looked up only once. The format is the first of the variadic arguments.
+ * \{
+ */
+#define DSC_BINARY_LOG(logger_id, level, ...) \
+  do { \
+    auto& dsc_binary_logger = Dune::Stuff::Common::BinaryLogger(); \
+    if (dsc_binary_logger.enabled()) { \
+      static const auto dsc_binary_log_logger = dsc_binary_logger.id(logger_id); \
+      static std::atomic< Dune::Stuff::Common::BinaryLogging::IdType > dsc_binary_log_format( \
+          Dune::Stuff::Common::BinaryLogging::unknown_id); \
+      dsc_binary_logger.log(dsc_binary_log_logger, level, dsc_binary_log_format, __VA_ARGS__); \
+    } \
+  } while (0)
+//! the first of the variadic arguments is the format
+#define DSC_BINARY_LOG_INFO(logger_id, ...) \
+  DSC_BINARY_LOG(logger_id, Dune::Stuff::Common::BinaryLogging::info, __VA_ARGS__)
+#define DSC_BINARY_LOG_DEBUG(logger_id, ...) \
+  DSC_BINARY_LOG(logger_id, Dune::Stuff::Common::BinaryLogging::debug, __VA_ARGS__)
+#define DSC_BINARY_LOG_WARN(logger_id, ...) \
+  DSC_BINARY_LOG(logger_id, Dune::Stuff::Common::BinaryLogging::warn, __VA_ARGS__)
+/**
+ * \}
+ */
+
+#endif // DUNE_STUFF_COMMON_BINARYLOGGING_HH
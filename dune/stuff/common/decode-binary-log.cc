@@ -0,0 +1,48 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+/**
+ * \file  decode-binary-log.cc
+ * \brief Turns a log written by BinaryLogging into the human readable format of TimedPrefixedLogStream.
+ *
+ *        Usage: dune-stuff-decode-binary-log BINARY_LOG [OUTPUT], writes to std::cout if no OUTPUT is given.
+ */
+
+#include "config.h"
+
+#include <fstream>
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/binarylogging.hh>
+
+int main(int argc, char** argv)
+{
+  if (argc < 2 || argc > 3) {
+    std::cerr << "usage: " << argv[0] << " BINARY_LOG [OUTPUT]" << std::endl;
+    return 1;
+  }
+  try {
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+      std::cerr << "could not open '" << argv[1] << "'!" << std::endl;
+      return 1;
+    }
+    if (argc == 3) {
+      std::ofstream out(argv[2]);
+      if (!out.is_open()) {
+        std::cerr << "could not open '" << argv[2] << "' for writing!" << std::endl;
+        return 1;
+      }
+      Dune::Stuff::Common::BinaryLogging::decode(in, out);
+    } else
+      Dune::Stuff::Common::BinaryLogging::decode(in, std::cout);
+  } catch (Dune::Exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+} // ... main(...)
@@ -23,6 +23,8 @@ Logging::Logging()
   , logflags_(LOG_NONE)
   , emptyLogStream_(logflags_)
 {
+  // make sure the sink is destroyed after this, we might hand it lines for logfile_
+  AsyncLogSink();
   for (const auto id : streamIDs_)
     streammap_[id] = make_unique<EmptyLogStream>(logflags_);
 }
@@ -30,6 +32,7 @@ Logging::Logging()
 void Logging::deinit()
 {
   streammap_.clear();
+  AsyncLogSink().flush();
   if ( (logflags_ & LOG_FILE) != 0 )
   {
     logfile_ << std::endl;
@@ -106,6 +109,7 @@ void Logging::flush() {
     assert(pair.second);
     pair.second->flush();
   }
+  AsyncLogSink().flush();
 } // flush
 
 int Logging::addStream(int flags) {
@@ -7,11 +7,232 @@
 
 #include <dune/common/unused.hh>
 
+#include <algorithm>
+#include <chrono>
+
 #include "logstreams.hh"
 
 namespace Dune {
 namespace Stuff {
 namespace Common {
+namespace {
+
+
+//! writes output to out directly or, if enabled, via AsyncLogSink()
+void write(std::ostream& out, const std::string& output)
+{
+  auto& sink = AsyncLogSink();
+  if (sink.enabled()) {
+    if (!output.empty())
+      sink.push(out, output);
+  } else {
+    out << output;
+    out.flush();
+  }
+} // ... write(...)
+
+/**
+ * \brief text with each line prefixed by elapsed_time_str(elapsed) + prefix, as written by TimedPrefixedLogStream
+ * \param prefix_first whether the first line of text starts a new line (or continues the last one)
+ */
+void prefix_lines(const std::string& text, const std::string& prefix, const double elapsed, const bool prefix_first,
+                  std::string& line)
+{
+  line.clear();
+  if (text.empty())
+    return;
+  const std::string line_prefix = elapsed_time_str(elapsed) + prefix;
+  if (prefix_first)
+    line += line_prefix;
+  auto lines = tokenize(text, "\n", boost::algorithm::token_compress_off);
+  assert(lines.size() > 0);
+  line += lines[0];
+  for (size_t ii = 1; ii < lines.size() - 1; ++ii)
+    line += "\n" + line_prefix + lines[ii];
+  if (lines.size() > 1) {
+    line += "\n";
+    const auto& last = lines.back();
+    if (!last.empty())
+      line += line_prefix + last;
+  }
+} // ... prefix_lines(...)
+
+
+} // namespace
+
+
+std::string elapsed_time_str(const double elapsed)
+{
+  const double secs_per_week = 604800;
+  const double secs_per_day  = 86400;
+  const double secs_per_hour = 3600;
+  const size_t weeks(   elapsed/secs_per_week);
+  const size_t days(   (elapsed - weeks*secs_per_week)/secs_per_day);
+  const size_t hours(  (elapsed - weeks*secs_per_week - days*secs_per_day)/3600.0);
+  const size_t minutes((elapsed - weeks*secs_per_week - days*secs_per_day - hours*secs_per_hour)/60.0);
+  const size_t seconds( elapsed - weeks*secs_per_week - days*secs_per_day - hours*secs_per_hour - minutes*60);
+  if (elapsed > secs_per_week)      // more than a week
+    return (boost::format("%02dw %02dd %02d:%02d:%02d|") % weeks % days % hours % minutes % seconds).str();
+  else if (elapsed > secs_per_day)  // less than a week, more than a day
+    return (boost::format("%02dd %02d:%02d:%02d|") % days % hours % minutes % seconds).str();
+  else if (elapsed > secs_per_hour) // less than a day, more than one hour
+    return (boost::format("%02d:%02d:%02d|") % hours % minutes % seconds).str();
+  else                              // less than one hour
+    return (boost::format("%02d:%02d|") % minutes % seconds).str();
+} // ... elapsed_time_str(...)
+
+
+AsynchronousLogSink::AsynchronousLogSink()
+  : mask_(0)
+  , enqueue_position_(0)
+  , written_(0)
+  , dropped_(0)
+  , enabled_(false)
+  , dequeue_position_(0)
+  , stop_(false)
+  , flush_waiters_(0)
+{}
+
+AsynchronousLogSink::~AsynchronousLogSink()
+{
+  disable();
+}
+
+void AsynchronousLogSink::enable(const size_t capacity)
+{
+  disable();
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  slots_ = std::vector< Slot, AlignedAllocator< Slot > >(size);
+  for (size_t ii = 0; ii < size; ++ii)
+    slots_[ii].sequence.store(ii, std::memory_order_relaxed);
+  mask_ = size - 1;
+  enqueue_position_ = 0;
+  written_ = 0;
+  dropped_ = 0;
+  dequeue_position_ = 0;
+  stop_ = false;
+  thread_ = std::thread([this]() { run(); });
+  enabled_ = true;
+} // ... enable(...)
+
+void AsynchronousLogSink::disable()
+{
+  if (!enabled_)
+    return;
+  enabled_ = false;
+  {
+    std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+} // ... disable(...)
+
+AsynchronousLogSink::Slot* AsynchronousLogSink::acquire(size_t& position)
+{
+  position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot* slot = &slots_[position & mask_];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        return slot;
+    } else if (difference < 0) {
+      // the background thread has not yet written this slot, the queue is full
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    } else
+      position = enqueue_position_.load(std::memory_order_relaxed);
+  }
+} // ... acquire(...)
+
+bool AsynchronousLogSink::push(std::ostream& out, const std::string& output)
+{
+  size_t position;
+  Slot* slot = acquire(position);
+  if (!slot)
+    return false;
+  slot->out = &out;
+  slot->output.assign(output);
+  slot->prefixed = false;
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+} // ... push(...)
+
+bool AsynchronousLogSink::push(std::ostream& out, const char* text, const size_t size, const std::string& prefix,
+                               const double elapsed, const bool prefix_first)
+{
+  size_t position;
+  Slot* slot = acquire(position);
+  if (!slot)
+    return false;
+  slot->out = &out;
+  slot->output.assign(text, size);
+  slot->prefixed = true;
+  slot->prefix.assign(prefix);
+  slot->elapsed = elapsed;
+  slot->prefix_first = prefix_first;
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+} // ... push(...)
+
+void AsynchronousLogSink::flush()
+{
+  if (!enabled_)
+    return;
+  const size_t target = enqueue_position_.load(std::memory_order_acquire);
+  std::unique_lock< std::mutex > lock(mutex_);
+  ++flush_waiters_;
+  wake_.notify_all();
+  written_condition_.wait(lock, [&]() { return written_.load(std::memory_order_acquire) >= target; });
+  --flush_waiters_;
+} // ... flush(...)
+
+void AsynchronousLogSink::run()
+{
+  static const size_t max_batch_size = 256;
+  static const std::chrono::milliseconds interval(2);
+  std::vector< std::ostream* > streams;
+  std::string line;
+  while (true) {
+    size_t batch_size = 0;
+    for (; batch_size < max_batch_size; ++batch_size) {
+      Slot& slot = slots_[dequeue_position_ & mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1)
+        break;
+      if (slot.prefixed) {
+        prefix_lines(slot.output, slot.prefix, slot.elapsed, slot.prefix_first, line);
+        slot.out->write(line.data(), line.size());
+      } else
+        slot.out->write(slot.output.data(), slot.output.size());
+      if (std::find(streams.begin(), streams.end(), slot.out) == streams.end())
+        streams.push_back(slot.out);
+      slot.sequence.store(dequeue_position_ + mask_ + 1, std::memory_order_release);
+      ++dequeue_position_;
+    }
+    for (auto& out : streams)
+      out->flush();
+    streams.clear();
+    std::unique_lock< std::mutex > lock(mutex_);
+    if (batch_size > 0) {
+      written_.store(dequeue_position_, std::memory_order_release);
+      written_condition_.notify_all();
+    } else if (stop_)
+      return;
+    else
+      wake_.wait_for(lock, interval, [&]() { return stop_ || flush_waiters_ > 0; });
+  }
+} // ... run(...)
+
+
+AsynchronousLogSink& AsyncLogSink()
+{
+  static AsynchronousLogSink sink;
+  return sink;
+}
 
 
 SuspendableStrBuffer::SuspendableStrBuffer(int loglevel, int& logflags)
@@ -78,49 +299,23 @@ TimedPrefixedStreamBuffer::TimedPrefixedStreamBuffer(const Timer& timer, const s
 int TimedPrefixedStreamBuffer::sync()
 {
   std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
-  const std::string tmp_str = str();
-  if (prefix_needed_ && !tmp_str.empty()) {
-    out_ << elapsed_time_str() << prefix_;
-    prefix_needed_ = false;
-  }
-  auto lines = tokenize(tmp_str, "\n", boost::algorithm::token_compress_off);
-  assert(lines.size() > 0);
-  out_ << lines[0];
-  for (size_t ii = 1; ii < lines.size() - 1; ++ii)
-    out_ << "\n" << elapsed_time_str() << prefix_ << lines[ii];
-  if (lines.size() > 1) {
-    out_ << "\n";
-    const auto& last = lines.back();
-    if (last.empty())
-      prefix_needed_ = true;
-    else
-      out_ << elapsed_time_str() << prefix_ << last;
+  // nothing is read from this buffer, so pbase() to pptr() is all output since the last sync
+  const auto size = size_t(pptr() - pbase());
+  if (size > 0) {
+    const bool prefix_first = prefix_needed_;
+    prefix_needed_ = pptr()[-1] == '\n';
+    auto& sink = AsyncLogSink();
+    if (sink.enabled())
+      sink.push(out_, pbase(), size, prefix_, timer_.elapsed(), prefix_first);
+    else {
+      prefix_lines(std::string(pbase(), size), prefix_, timer_.elapsed(), prefix_first, line_);
+      write(out_, line_);
+    }
   }
-  out_.flush();
   str("");
   return 0;
 } // ... sync(...)
 
-std::string TimedPrefixedStreamBuffer::elapsed_time_str() const
-{
-  const double secs_per_week = 604800;
-  const double secs_per_day  = 86400;
-  const double secs_per_hour = 3600;
-  const double elapsed = timer_.elapsed();
-  const size_t weeks(   elapsed/secs_per_week);
-  const size_t days(   (elapsed - weeks*secs_per_week)/secs_per_day);
-  const size_t hours(  (elapsed - weeks*secs_per_week - days*secs_per_day)/3600.0);
-  const size_t minutes((elapsed - weeks*secs_per_week - days*secs_per_day - hours*secs_per_hour)/60.0);
-  const size_t seconds( elapsed - weeks*secs_per_week - days*secs_per_day - hours*secs_per_hour - minutes*60);
-  if (elapsed > secs_per_week)      // more than a week
-    return (boost::format("%02dw %02dd %02d:%02d:%02d|") % weeks % days % hours % minutes % seconds).str();
-  else if (elapsed > secs_per_day)  // less than a week, more than a day
-    return (boost::format("%02dd %02d:%02d:%02d|") % days % hours % minutes % seconds).str();
-  else if (elapsed > secs_per_hour) // less than a day, more than one hour
-    return (boost::format("%02d:%02d:%02d|") % hours % minutes % seconds).str();
-  else                              // less than one hour
-    return (boost::format("%02d:%02d|") % minutes % seconds).str();
-} // ... elapsed_time(...)
 
 
 LogStream& LogStream::flush()
@@ -145,10 +340,9 @@ TimedPrefixedLogStream::~TimedPrefixedLogStream()
 int FileBuffer::sync() {
   // flush buffer into stream
   std::lock_guard<std::mutex> guard(sync_mutex_);
-  std::cout << str();
-  std::cout.flush();
-  logfile_ << str();
-  logfile_.flush();
+  const std::string output = str();
+  write(std::cout, output);
+  write(logfile_, output);
   str("");
   return 0;
 }
@@ -12,6 +12,10 @@
 #include <iostream>
 #include <type_traits>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <vector>
 
 #include <dune/common/timer.hh>
 
@@ -35,6 +39,114 @@ enum LogFlags
 };
 
 
+//! \return elapsed seconds as printed by TimedPrefixedLogStream, e.g. "01:02|"
+std::string elapsed_time_str(const double elapsed);
+
+
+/**
+ * \brief Writes log output to its streams on a background thread.
+ *
+ *        Once enabled, FileBuffer and TimedPrefixedStreamBuffer hand their output to
+ *        this sink on each flush instead of writing it to their streams themselves: the calling thread copies the
+ *        raw output (and, for TimedPrefixedStreamBuffer, the prefix and a time stamp) into a slot of a bounded
+ *        lock-free queue, while a background thread prefixes the lines, writes all queued output in batches and
+ *        flushes each stream only once per batch. If the queue is full the output is dropped and counted (see
+ *        dropped()), so logging never blocks. Output of one thread keeps its order, output of different threads is
+ *        written in the order it was queued.
+\code
+AsyncLogSink().enable();
+// ... log from many threads
+AsyncLogSink().flush(); // all output queued so far has been written
+\endcode
+ * \note  enable() and disable() must not be called concurrently with logging, the streams written to have to outlive
+ *        the next call to flush() or disable().
+ * \note  Most likely you do not want to use this class directly but AsyncLogSink() instead.
+ */
+class AsynchronousLogSink
+{
+public:
+  static const size_t default_capacity = 4096;
+
+  AsynchronousLogSink();
+
+  ~AsynchronousLogSink();
+
+  //! starts the background thread, capacity is rounded up to the next power of two
+  void enable(const size_t capacity = default_capacity);
+
+  //! writes all queued output and stops the background thread, no-op if not enabled
+  void disable();
+
+  bool enabled() const
+  {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * \brief queues output to be written to out
+   * \return false if the queue was full and the output has been dropped
+   */
+  bool push(std::ostream& out, const std::string& output);
+
+  /**
+   * \brief queues text to be written to out, each line prefixed by elapsed_time_str(elapsed) + prefix
+   * \param prefix_first whether the first line of text starts a new line in out (or continues the last one)
+   * \return false if the queue was full and the output has been dropped
+   */
+  bool push(std::ostream& out, const char* text, const size_t size, const std::string& prefix, const double elapsed,
+            const bool prefix_first);
+
+  //! blocks until all output queued so far has been written
+  void flush();
+
+  //! \return the number of outputs dropped since the last call to enable()
+  size_t dropped() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct alignas(cache_line_size) Slot
+  {
+    //! the queue position this slot is ready to be written at (as position), or read at (as position + 1)
+    std::atomic< size_t > sequence;
+    std::ostream* out;
+    std::string output;
+    //! whether output has to be prefixed by the background thread, see the second push()
+    bool prefixed;
+    std::string prefix;
+    double elapsed;
+    bool prefix_first;
+  };
+
+  //! \return a free slot for position, or nullptr if the queue is full
+  Slot* acquire(size_t& position);
+
+  void run();
+
+  AsynchronousLogSink(const AsynchronousLogSink&) = delete;
+
+  std::vector< Slot, AlignedAllocator< Slot > > slots_;
+  size_t mask_;
+  alignas(cache_line_size) std::atomic< size_t > enqueue_position_;
+  alignas(cache_line_size) std::atomic< size_t > written_;
+  std::atomic< size_t > dropped_;
+  std::atomic< bool > enabled_;
+  //! only touched by the background thread
+  size_t dequeue_position_;
+  bool stop_;
+  size_t flush_waiters_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable written_condition_;
+  std::thread thread_;
+}; // class AsynchronousLogSink
+
+
+//! global instance of the asynchronous log sink, disabled until AsynchronousLogSink::enable() is called
+AsynchronousLogSink& AsyncLogSink();
+
+
 class SuspendableStrBuffer
   : public std::basic_stringbuf< char, std::char_traits<char> >
 {
@@ -126,12 +238,13 @@ public:
 private:
   TimedPrefixedStreamBuffer(const TimedPrefixedStreamBuffer&) = delete;
 
-  std::string elapsed_time_str() const;
-
   const Timer& timer_;
   const std::string prefix_;
   std::ostream& out_;
   bool prefix_needed_;
+  //! reused for the prefixed output if AsyncLogSink() is disabled
+  std::string line_;
+  //! only guards the buffer, the lines are prefixed by AsyncLogSink() if enabled
   std::mutex mutex_;
 }; // class TimedPrefixedStreamBuffer
 
@@ -7,6 +7,10 @@
 #define DUNE_STUFF_MEMORY_HH
 
 #include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <type_traits>
 #include <boost/noncopyable.hpp>
 
 namespace Dune {
@@ -21,6 +25,74 @@ std::unique_ptr<T> make_unique(Args&& ...args)
   return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
 }
 
+//! (assumed) size of a cache line in bytes
+static const std::size_t cache_line_size = 64;
+
+//! allocator handing out memory aligned to alignment bytes (e.g. for SIMD loads or to avoid false sharing)
+template< class T, std::size_t alignment = cache_line_size >
+struct AlignedAllocator
+{
+  static_assert(alignment >= alignof(void*) && (alignment & (alignment - 1)) == 0,
+                "alignment has to be a power of two and a multiple of sizeof(void*)!");
+
+  typedef T              value_type;
+  typedef T*             pointer;
+  typedef const T*       const_pointer;
+  typedef T&             reference;
+  typedef const T&       const_reference;
+  typedef std::size_t    size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::true_type propagate_on_container_move_assignment;
+
+  template< class U >
+  struct rebind
+  {
+    typedef AlignedAllocator< U, alignment > other;
+  };
+
+  AlignedAllocator() = default;
+
+  template< class U >
+  AlignedAllocator(const AlignedAllocator< U, alignment >& /*other*/)
+  {}
+
+  T* allocate(const std::size_t num)
+  {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, num * sizeof(T)) != 0)
+      throw std::bad_alloc();
+    return static_cast< T* >(ptr);
+  }
+
+  void deallocate(T* ptr, const std::size_t /*num*/)
+  {
+    std::free(ptr);
+  }
+}; // struct AlignedAllocator
+
+template< class T, class U, std::size_t alignment >
+bool operator==(const AlignedAllocator< T, alignment >&, const AlignedAllocator< U, alignment >&)
+{
+  return true;
+}
+
+template< class T, class U, std::size_t alignment >
+bool operator!=(const AlignedAllocator< T, alignment >&, const AlignedAllocator< U, alignment >&)
+{
+  return false;
+}
+
+//! places a T in cache lines of its own, use with AlignedAllocator when storing these in containers
+template< class T >
+struct alignas(cache_line_size) CacheLinePadded
+{
+  explicit CacheLinePadded(const T& val)
+    : value(val)
+  {}
+
+  T value;
+}; // struct CacheLinePadded
+
 //! just like boost::noncopyable, but for move assign/ctor
 struct nonmoveable
 {
@@ -2,6 +2,17 @@
 #define DUNE_STUFF_COMMON_PARALLEL_PARTITIONER_HH
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/exceptions.hh>
 
 namespace Dune {
 namespace Stuff {
@@ -33,6 +44,263 @@ private:
   const IndexSetType& index_set_;
 };
 
+#if HAVE_DUNE_GRID
+
+/** \brief Colors the partitions of a given partitioner, such that partitions of the same color can be walked in
+ * parallel without write conflicts
+ *
+ * Two partitions P and Q get different colors, if a vertex of an element of P or one of its face neighbors coincides
+ * with a vertex of an element of Q or one of its face neighbors. Thus codim-0 and codim-1 functors scattering into
+ * element, face or vertex based data of the inside and outside entities (e.g., via add_to_entry() of a matrix that is
+ * not shared with other containers) never touch the same data from two partitions of the same color.
+ * The partitions are renumbered, such that the partitions of color c are [color_begin(c), color_end(c)). Use this
+ * with \ref Dune::SeedListPartitioning and Walker::walk(partitioning, coloring).
+ **/
+template <class GridViewType, class PartitionerType>
+class ColoredPartitioner {
+public:
+  typedef typename GridViewType::template Codim<0>::Entity EntityType;
+
+  ColoredPartitioner(const GridViewType& grid_view, const PartitionerType& partitioner)
+    : partitioner_(partitioner)
+  {
+    const auto num_partitions = partitioner_.partitions();
+    const auto& index_set = grid_view.indexSet();
+    static const int dimension = GridViewType::dimension;
+    // for each vertex all partitions whose closure (elements + face neighbors) contain the vertex
+    std::vector<std::vector<std::size_t>> partitions_of_vertex(index_set.size(dimension));
+    for (const auto& entity : DSC::entityRange(grid_view)) {
+      std::vector<std::size_t> closure(1, partitioner_.partition(entity));
+      const auto intersection_it_end = grid_view.iend(entity);
+      for (auto intersection_it = grid_view.ibegin(entity); intersection_it != intersection_it_end; ++intersection_it) {
+        if (intersection_it->neighbor()) {
+          const auto neighbor_ptr = intersection_it->outside();
+          closure.push_back(partitioner_.partition(*neighbor_ptr));
+        }
+      }
+      for (int vv = 0; vv < entity.template count<dimension>(); ++vv) {
+        auto& partitions = partitions_of_vertex[index_set.subIndex(entity, vv, dimension)];
+        partitions.insert(partitions.end(), closure.begin(), closure.end());
+      }
+    }
+    // conflict graph
+    std::vector<std::set<std::size_t>> conflicts(num_partitions);
+    for (auto& partitions : partitions_of_vertex) {
+      std::sort(partitions.begin(), partitions.end());
+      partitions.erase(std::unique(partitions.begin(), partitions.end()), partitions.end());
+      for (auto pp : partitions)
+        for (auto qq : partitions)
+          if (pp != qq)
+            conflicts[pp].insert(qq);
+    }
+    // greedy coloring in order of the original partition numbers
+    std::vector<std::size_t> color_of_partition(num_partitions, 0);
+    std::size_t num_colors = 0;
+    for (std::size_t pp = 0; pp < num_partitions; ++pp) {
+      std::vector<bool> used(num_colors + 1, false);
+      for (auto qq : conflicts[pp])
+        if (qq < pp)
+          used[color_of_partition[qq]] = true;
+      const auto color = std::size_t(std::find(used.begin(), used.end(), false) - used.begin());
+      color_of_partition[pp] = color;
+      num_colors = std::max(num_colors, color + 1);
+    }
+    // renumber partitions, such that colors are contiguous
+    color_offsets_.assign(num_colors + 1, 0);
+    for (auto color : color_of_partition)
+      ++color_offsets_[color + 1];
+    for (std::size_t cc = 0; cc < num_colors; ++cc)
+      color_offsets_[cc + 1] += color_offsets_[cc];
+    auto next = color_offsets_;
+    new_partition_.resize(num_partitions);
+    for (std::size_t pp = 0; pp < num_partitions; ++pp)
+      new_partition_[pp] = next[color_of_partition[pp]]++;
+  } // ColoredPartitioner(...)
+
+  std::size_t partition(const EntityType &e) const
+  {
+    return new_partition_[partitioner_.partition(e)];
+  }
+
+  std::size_t partitions() const
+  {
+    return new_partition_.size();
+  }
+
+  std::size_t colors() const
+  {
+    return color_offsets_.size() - 1;
+  }
+
+  std::size_t color_begin(const std::size_t color) const
+  {
+    return color_offsets_[color];
+  }
+
+  std::size_t color_end(const std::size_t color) const
+  {
+    return color_offsets_[color + 1];
+  }
+
+private:
+  const PartitionerType& partitioner_;
+  std::vector<std::size_t> new_partition_;
+  std::vector<std::size_t> color_offsets_;
+};
+
+enum class SpaceFillingCurve { hilbert, morton };
+
+/** \brief Partitions the codim-0 entities of a grid view into contiguous pieces of a space filling curve
+ *
+ * The entities are ordered along a Hilbert (or Morton) curve through their barycenters, which is then cut into
+ * partitions() pieces of (about) equal weight. Each partition is thus spatially compact, which improves cache reuse
+ * of vertex and face data shared by its elements and reduces the number of neighboring partitions.
+ * Usable with \ref Dune::SeedListPartitioning and Walker::walk(partitioning), see also \ref ColoredPartitioner.
+ **/
+template <class GridViewType>
+class SpaceFillingCurvePartitioner {
+public:
+  typedef typename GridViewType::IndexSet IndexSetType;
+  typedef typename GridViewType::template Codim<0>::Entity EntityType;
+  static const int dimension = GridViewType::dimension;
+
+  /** \param num_partitions is bounded by the number of entities
+   *  \param weights        optional nonnegative weights per entity index, defaults to 1 for each entity
+   **/
+  SpaceFillingCurvePartitioner(const GridViewType& grid_view,
+                               const std::size_t num_partitions,
+                               const SpaceFillingCurve curve = SpaceFillingCurve::hilbert,
+                               const std::vector<double>& weights = std::vector<double>())
+    : index_set_(grid_view.indexSet())
+    , num_partitions_(std::max(std::size_t(1), std::min(num_partitions, std::size_t(index_set_.size(0)))))
+  {
+    typedef typename GridViewType::ctype DomainFieldType;
+    const auto num_entities = index_set_.size(0);
+    std::vector<Dune::FieldVector<DomainFieldType, dimension>> centers(num_entities);
+    Dune::FieldVector<DomainFieldType, dimension> lower(std::numeric_limits<DomainFieldType>::max());
+    Dune::FieldVector<DomainFieldType, dimension> upper(std::numeric_limits<DomainFieldType>::lowest());
+    for (const auto& entity : DSC::entityRange(grid_view)) {
+      const auto center = entity.geometry().center();
+      centers[index_set_.index(entity)] = center;
+      for (int dd = 0; dd < dimension; ++dd) {
+        lower[dd] = std::min(lower[dd], center[dd]);
+        upper[dd] = std::max(upper[dd], center[dd]);
+      }
+    }
+    // quantize the barycenters to the integer lattice of the curve
+    const double max_coordinate = double((std::uint64_t(1) << bits) - 1);
+    std::vector<std::uint64_t> keys(num_entities);
+    std::uint32_t coordinates[dimension];
+    for (std::size_t ii = 0; ii < num_entities; ++ii) {
+      for (int dd = 0; dd < dimension; ++dd) {
+        const auto extent = upper[dd] - lower[dd];
+        const double relative = extent > 0 ? (centers[ii][dd] - lower[dd]) / extent : 0.;
+        coordinates[dd] = std::uint32_t(relative * max_coordinate);
+      }
+      if (curve == SpaceFillingCurve::hilbert)
+        to_hilbert_transpose(coordinates);
+      keys[ii] = interleave(coordinates);
+    }
+    order_.resize(num_entities);
+    std::iota(order_.begin(), order_.end(), std::size_t(0));
+    std::stable_sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+    cut(weights);
+  } // SpaceFillingCurvePartitioner(...)
+
+  /** \brief cuts the curve anew, such that the partitions have (about) the same sum of weights
+   *  \param weights nonnegative weight per entity index, all entities weigh 1 if empty
+   **/
+  void cut(const std::vector<double>& weights)
+  {
+    const auto num_entities = order_.size();
+    if (!weights.empty() && weights.size() != num_entities)
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "weights.size() = " << weights.size() << ", number of entities = " << num_entities);
+    const auto weight = [&](const std::size_t index) { return weights.empty() ? 1. : std::max(0., weights[index]); };
+    double total = 0;
+    for (std::size_t ii = 0; ii < num_entities; ++ii)
+      total += weight(ii);
+    const bool unweighted = !(total > 0);
+    if (unweighted)
+      total = double(num_entities);
+    // each entity goes to the partition containing the center of its weight interval along the curve
+    partition_of_index_.resize(num_entities);
+    double before = 0;
+    for (const auto index : order_) {
+      const double ww = unweighted ? 1. : weight(index);
+      const auto partition = std::size_t((before + 0.5 * ww) * double(num_partitions_) / total);
+      partition_of_index_[index] = std::min(partition, num_partitions_ - 1);
+      before += ww;
+    }
+  } // ... cut(...)
+
+  std::size_t partition(const EntityType &e) const
+  {
+    return partition_of_index_[index_set_.index(e)];
+  }
+
+  std::size_t partition_of_index(const std::size_t index) const
+  {
+    return partition_of_index_[index];
+  }
+
+  std::size_t partitions() const
+  {
+    return num_partitions_;
+  }
+
+private:
+  //! bits per coordinate, such that the interleaved key fits into 64 bits
+  static const int bits = (dimension == 1 || 64 / dimension > 32) ? 32 : 64 / dimension;
+
+  //! transforms coordinates to the transposed Hilbert index (J. Skilling, AIP Conf. Proc. 707, 2004)
+  static void to_hilbert_transpose(std::uint32_t (&x)[dimension])
+  {
+    if (dimension == 1)
+      return;
+    const std::uint32_t top = std::uint32_t(1) << (bits - 1);
+    // inverse undo
+    for (std::uint32_t q = top; q > 1; q >>= 1) {
+      const std::uint32_t p = q - 1;
+      for (int ii = 0; ii < dimension; ++ii) {
+        if (x[ii] & q)
+          x[0] ^= p;
+        else {
+          const std::uint32_t t = (x[0] ^ x[ii]) & p;
+          x[0] ^= t;
+          x[ii] ^= t;
+        }
+      }
+    }
+    // gray encode
+    for (int ii = 1; ii < dimension; ++ii)
+      x[ii] ^= x[ii - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t q = top; q > 1; q >>= 1)
+      if (x[dimension - 1] & q)
+        t ^= q - 1;
+    for (int ii = 0; ii < dimension; ++ii)
+      x[ii] ^= t;
+  } // ... to_hilbert_transpose(...)
+
+  static std::uint64_t interleave(const std::uint32_t (&x)[dimension])
+  {
+    std::uint64_t key = 0;
+    for (int bb = bits - 1; bb >= 0; --bb)
+      for (int dd = 0; dd < dimension; ++dd)
+        key = (key << 1) | ((x[dd] >> bb) & 1u);
+    return key;
+  }
+
+  const IndexSetType& index_set_;
+  const std::size_t num_partitions_;
+  //! entity indices in curve order
+  std::vector<std::size_t> order_;
+  std::vector<std::size_t> partition_of_index_;
+};
+
+#endif // HAVE_DUNE_GRID
+
 }
 }
 
@@ -23,13 +23,276 @@
 
 #if HAVE_TBB
 
+#include <atomic>
+#include <set>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+
 #include <tbb/compat/thread>
+#include <tbb/task_scheduler_observer.h>
+
+#ifdef __linux__
+# include <sched.h>
+#endif
+
+namespace {
+
+/** slot indices for ThreadManager::thread(), assigned once per thread
+ *  New slots come from an atomic counter. Slots released by exited threads (e.g. after tbb re-initialization with
+ *  fewer threads) are kept in a set and the smallest of them is handed out before a new one. Only releasing and reusing
+ *  slots takes the mutex.
+ **/
+class ThreadSlots
+{
+public:
+  static size_t acquire()
+  {
+    if (num_released().load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> guard(mutex());
+      if (!released().empty()) {
+        const auto slot = *released().begin();
+        released().erase(released().begin());
+        num_released().store(released().size(), std::memory_order_release);
+        return slot;
+      }
+    }
+    return next().fetch_add(1, std::memory_order_relaxed);
+  }
+
+  //! \return the smallest free slot if it is smaller than slot, which is released then, slot otherwise
+  static size_t exchange(const size_t slot)
+  {
+    std::lock_guard<std::mutex> guard(mutex());
+    if (released().empty() || *released().begin() > slot)
+      return slot;
+    const auto smaller = *released().begin();
+    released().erase(released().begin());
+    released().insert(slot);
+    return smaller;
+  }
+
+  static void release(const size_t slot)
+  {
+    std::lock_guard<std::mutex> guard(mutex());
+    released().insert(slot);
+    num_released().store(released().size(), std::memory_order_release);
+    bump_generation();
+  }
+
+  //! changes whenever an exchange() might succeed where it failed before
+  static size_t generation()
+  {
+    return generation_counter().load(std::memory_order_acquire);
+  }
+
+  //! to be called when slots are released or the slot limit changes
+  static void bump_generation()
+  {
+    generation_counter().fetch_add(1, std::memory_order_acq_rel);
+  }
+
+private:
+  static std::atomic<size_t>& next()
+  {
+    static std::atomic<size_t> next_slot(0);
+    return next_slot;
+  }
+
+  static std::atomic<size_t>& num_released()
+  {
+    static std::atomic<size_t> count(0);
+    return count;
+  }
+
+  static std::atomic<size_t>& generation_counter()
+  {
+    static std::atomic<size_t> counter(0);
+    return counter;
+  }
+
+  static std::mutex& mutex()
+  {
+    static std::mutex mtx;
+    return mtx;
+  }
+
+  static std::set<size_t>& released()
+  {
+    static std::set<size_t> slots;
+    return slots;
+  }
+};
+
+struct ThreadSlot
+{
+  ThreadSlot()
+    : generation(ThreadSlots::generation())
+    , index(ThreadSlots::acquire())
+  {}
+
+  ~ThreadSlot()
+  {
+    ThreadSlots::release(index);
+  }
+
+  //! of ThreadSlots when index was last assigned
+  size_t generation;
+  size_t index;
+};
+
+/** \return the slot of the calling thread
+ *  A slot >= max_slots (the thread got it before the pool was shrunk, or more threads than slots are alive) is
+ *  exchanged for a smaller free one if there is any, otherwise it is returned as is. The exchange is only retried
+ *  after slots have been released or the slot limit has changed, so this only locks in these cases. Never throws.
+ **/
+size_t thread_slot(const size_t max_slots)
+{
+  static thread_local ThreadSlot slot;
+  if (slot.index >= max_slots) {
+    // read before the exchange, so a release racing with it is noticed on the next call
+    const auto generation = ThreadSlots::generation();
+    if (generation != slot.generation) {
+      slot.generation = generation;
+      slot.index = ThreadSlots::exchange(slot.index);
+    }
+  }
+  return slot.index;
+} // ... thread_slot(...)
+
+//! cpu ids in a list like "0-7,16-23" as found in /sys/devices/system/node
+std::vector<int> read_cpulist(const std::string& filename)
+{
+  std::vector<int> ret;
+  std::ifstream file(filename);
+  std::string range;
+  while (std::getline(file, range, ',')) {
+    int first = 0;
+    int last = 0;
+    const auto matched = std::sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (matched < 1)
+      continue;
+    if (matched == 1)
+      last = first;
+    for (int cpu = first; cpu <= last; ++cpu)
+      ret.push_back(cpu);
+  }
+  return ret;
+} // ... read_cpulist(...)
+
+//! the cpus this process may run on, grouped by NUMA node
+std::vector<std::vector<int>> numa_topology()
+{
+  std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  const bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+  const auto usable = [&](const int cpu) { return !have_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)); };
+  for (const int node : read_cpulist("/sys/devices/system/node/online")) {
+    std::vector<int> cpus;
+    for (const int cpu : read_cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+      if (usable(cpu))
+        cpus.push_back(cpu);
+    if (!cpus.empty())
+      nodes.push_back(cpus);
+  }
+  if (nodes.empty()) {
+    nodes.emplace_back();
+    for (int cpu = 0; cpu < int(std::thread::hardware_concurrency()); ++cpu)
+      if (usable(cpu))
+        nodes.back().push_back(cpu);
+  }
+#endif // __linux__
+  if (nodes.empty())
+    nodes.emplace_back();
+  return nodes;
+} // ... numa_topology(...)
+
+/** the cpu for each thread index (modulo the number of cpus)
+ *  compact: all cpus of node 0, then all of node 1, ...
+ *  scatter: first cpu of each node, then the second cpu of each node, ...
+ **/
+std::vector<int> placement(const Dune::Stuff::ThreadManager::Affinity affinity)
+{
+  typedef Dune::Stuff::ThreadManager::Affinity Affinity;
+  std::vector<int> ret;
+  const auto nodes = numa_topology();
+  if (affinity == Affinity::compact) {
+    for (const auto& cpus : nodes)
+      ret.insert(ret.end(), cpus.begin(), cpus.end());
+  } else if (affinity == Affinity::scatter) {
+    size_t max_node_size = 0;
+    for (const auto& cpus : nodes)
+      max_node_size = std::max(max_node_size, cpus.size());
+    for (size_t ii = 0; ii < max_node_size; ++ii)
+      for (const auto& cpus : nodes)
+        if (ii < cpus.size())
+          ret.push_back(cpus[ii]);
+  }
+  return ret;
+} // ... placement(...)
+
+} // namespace
+
+/** pins threads entering the tbb scheduler according to a placement
+ *  an empty placement restores the affinity mask the process started with
+ *  Gets the slot limit directly and never calls threadManager(), it is created while that singleton is still being
+ *  constructed if threading.affinity is set.
+ **/
+class Dune::Stuff::ThreadManager::AffinityObserver
+  : public tbb::task_scheduler_observer
+{
+public:
+  AffinityObserver(std::vector<int> cpus, const std::atomic<size_t>& max_slots)
+    : cpus_(std::move(cpus))
+    , max_slots_(max_slots)
+  {
+#ifdef __linux__
+    CPU_ZERO(&process_mask_);
+    have_process_mask_ = sched_getaffinity(0, sizeof(process_mask_), &process_mask_) == 0;
+#endif
+    observe(true);
+  }
+
+  virtual ~AffinityObserver()
+  {
+    observe(false);
+  }
+
+  virtual void on_scheduler_entry(bool /*is_worker*/) override
+  {
+#ifdef __linux__
+    if (cpus_.empty()) {
+      if (have_process_mask_)
+        sched_setaffinity(0, sizeof(process_mask_), &process_mask_);
+      return;
+    }
+    const auto index = thread_slot(max_slots_.load(std::memory_order_relaxed));
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpus_[index % cpus_.size()], &mask);
+    sched_setaffinity(0, sizeof(mask), &mask);
+#endif // __linux__
+  } // ... on_scheduler_entry(...)
+
+private:
+  const std::vector<int> cpus_;
+  const std::atomic<size_t>& max_slots_;
+#ifdef __linux__
+  cpu_set_t process_mask_;
+  bool have_process_mask_;
+#endif
+}; // class ThreadManager::AffinityObserver
 
 size_t Dune::Stuff::ThreadManager::max_threads()
 {
-  const auto threads = DSC_CONFIG_GET("threading.max_count", 1);
-  WITH_DUNE_FEM(assert(Dune::Fem::ThreadManager::maxThreads() == threads);)
-  return threads;
+  WITH_DUNE_FEM(assert(Dune::Fem::ThreadManager::maxThreads() == max_threads_);)
+  return max_threads_;
 }
 
 size_t Dune::Stuff::ThreadManager::current_threads()
@@ -41,36 +304,73 @@ size_t Dune::Stuff::ThreadManager::current_threads()
 
 size_t Dune::Stuff::ThreadManager::thread()
 {
-  const auto tbb_id = tbb::this_tbb_thread::get_id();
-  static std::map<decltype(tbb_id), size_t> thread_ids;
-  const auto it = thread_ids.find(tbb_id);
-  if (it==thread_ids.end())
-    thread_ids.emplace(tbb_id, thread_ids.size());
-  return thread_ids.at(tbb_id);
+  return thread_slot(max_threads_.load(std::memory_order_relaxed));
 }
 
 void Dune::Stuff::ThreadManager::set_max_threads(const size_t count)
 {
-  max_threads_ = count;
   WITH_DUNE_FEM(Dune::Fem::ThreadManager::setMaxNumberThreads(boost::numeric_cast< int >(count));)
 #if HAVE_EIGEN
   Eigen::setNbThreads(boost::numeric_cast< int >(count));
 #endif
-  tbb_init_->terminate();
-  tbb_init_->initialize(boost::numeric_cast< int >(count));
+  // publish the new slot limit before new workers ask for their thread()
+  const auto previous = max_threads_.exchange(count);
+  ThreadSlots::bump_generation();
+  if (count != previous || !tbb_init_->is_active()) {
+    if (tbb_init_->is_active())
+      tbb_init_->terminate();
+    tbb_init_->initialize(boost::numeric_cast< int >(count));
+  }
+}
+
+Dune::Stuff::ThreadManager::Affinity Dune::Stuff::ThreadManager::affinity() const
+{
+  return affinity_;
+}
+
+void Dune::Stuff::ThreadManager::set_affinity(const Affinity affinity)
+{
+  if (affinity == affinity_)
+    return;
+  // destroy the old observer first, the new one records the process mask
+  const bool was_pinned = affinity_ != Affinity::none;
+  affinity_observer_.reset();
+  affinity_ = affinity;
+  if (affinity_ != Affinity::none || was_pinned)
+    affinity_observer_ = Common::make_unique<AffinityObserver>(placement(affinity_), max_threads_);
+}
+
+size_t Dune::Stuff::ThreadManager::numa_nodes() const
+{
+  return numa_topology().size();
 }
 
 Dune::Stuff::ThreadManager::ThreadManager()
   : max_threads_(1)
+  , affinity_(Affinity::none)
   , tbb_init_(nullptr)
+  , affinity_observer_(nullptr)
 {
 #if HAVE_EIGEN
   // must be called before tbb threads are created via tbb::task_scheduler_init object ctor
   Eigen::initParallel();
   Eigen::setNbThreads(1);
 #endif
-  tbb_init_ = Common::make_unique<tbb::task_scheduler_init>(boost::numeric_cast< int >(max_threads_));
-  set_max_threads(std::thread::hardware_concurrency());
+  tbb_init_ = Common::make_unique<tbb::task_scheduler_init>(boost::numeric_cast< int >(max_threads_.load()));
+  set_max_threads(DSC_CONFIG_GET("threading.max_count", std::max(1u, std::thread::hardware_concurrency())));
+  const auto affinity = DSC_CONFIG_GET("threading.affinity", std::string("none"));
+  if (affinity == "compact")
+    set_affinity(Affinity::compact);
+  else if (affinity == "scatter")
+    set_affinity(Affinity::scatter);
+  else if (affinity != "none")
+    DUNE_THROW(Exceptions::configuration_error,
+               "threading.affinity has to be one of none, compact or scatter, is '" << affinity << "'!");
+}
+
+Dune::Stuff::ThreadManager::~ThreadManager()
+{
+  affinity_observer_.reset();
 }
 
 #else // if HAVE_TBB
@@ -87,7 +387,7 @@ size_t Dune::Stuff::ThreadManager::current_threads()
 
 size_t Dune::Stuff::ThreadManager::thread()
 {
-    return 1;
+    return 0;
 }
 
 void Dune::Stuff::ThreadManager::set_max_threads(const size_t count)
@@ -96,8 +396,26 @@ void Dune::Stuff::ThreadManager::set_max_threads(const size_t count)
     DUNE_THROW(InvalidStateException, "Trying to use more than one thread w/o TBB");
 }
 
+Dune::Stuff::ThreadManager::Affinity Dune::Stuff::ThreadManager::affinity() const
+{
+  return affinity_;
+}
+
+void Dune::Stuff::ThreadManager::set_affinity(const Affinity affinity)
+{
+  affinity_ = affinity;
+}
+
+size_t Dune::Stuff::ThreadManager::numa_nodes() const
+{
+  return 1;
+}
+
 Dune::Stuff::ThreadManager::ThreadManager()
  : max_threads_(1)
+ , affinity_(Affinity::none)
 {}
 
+Dune::Stuff::ThreadManager::~ThreadManager() = default;
+
 #endif // HAVE_DUNE_FEM
@@ -7,6 +7,8 @@
 #define DUNE_STUFF_COMMON_THREADMANAGER_HH
 
 #include <thread>
+#include <memory>
+#include <atomic>
 #if HAVE_TBB
 # include <tbb/task_scheduler_init.h>
 #endif
@@ -20,30 +22,57 @@ ThreadManager& threadManager();
 
 /** abstractions of threading functionality
  *  currently controls tbb and forwards to dune-fem if possible, falls back to single-thread dummy imp
+ *
+ *  The thread count is read once from threading.max_count (defaults to the hardware concurrency) and cached, use
+ *  set_max_threads() to change it later on. Worker threads may be pinned to cores via threading.affinity
+ *  (none, compact or scatter), see set_affinity().
  **/
 struct ThreadManager
 {
+  /** placement of the threads on the cores of the machine
+   *  compact fills one NUMA node after the other, scatter distributes consecutive threads round robin over the nodes
+   **/
+  enum class Affinity { none, compact, scatter };
+
   //! return maximal number of threads possbile in the current run
   size_t max_threads();
 
   //! return number of current threads
   size_t current_threads();
 
-  //! return thread number
+  /** \return index of the calling thread, the smallest free one on the first call per thread, cached afterwards
+   *  An index >= max_threads() (left over from before the pool was shrunk) is exchanged for a smaller free one. The
+   *  result lies in [0, max_threads()) unless more distinct threads than max_threads() are alive and call this, so
+   *  callers indexing arrays of max_threads() entries have to check it. Never throws.
+   **/
   size_t thread();
 
-  //! set maximal number of threads available during run
+  //! set maximal number of threads available during run, the scheduler is only re-initialized if count changes
   void set_max_threads( const size_t count );
 
-  ~ThreadManager() = default;
+  Affinity affinity() const;
+
+  /** pin each thread to the core given by its thread() index and the chosen placement
+   *  Data allocated and first written by a pinned thread (e.g. the values of a PerThreadValue) stays on its NUMA node.
+   *  Only has an effect on linux with tbb, Affinity::none releases the pinning of threads entering the scheduler.
+   **/
+  void set_affinity( const Affinity affinity );
+
+  //! number of NUMA nodes available to this process, 1 if unknown
+  size_t numa_nodes() const;
+
+  ~ThreadManager();
 private:
   friend ThreadManager& threadManager();
   //! init tbb with given thread count, prepare Eigen for smp if possible
   ThreadManager();
 
-  size_t max_threads_;
+  std::atomic<size_t> max_threads_;
+  Affinity affinity_;
 #if HAVE_TBB
+  class AffinityObserver;
   std::unique_ptr<tbb::task_scheduler_init> tbb_init_;
+  std::unique_ptr<AffinityObserver> affinity_observer_;
 #endif
 };
 
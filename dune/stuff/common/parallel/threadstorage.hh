@@ -6,14 +6,17 @@
 #ifndef DUNE_STUFF_PARALLEL_THREADSTORAGE_HH
 #define DUNE_STUFF_PARALLEL_THREADSTORAGE_HH
 
-#include <deque>
+#include <vector>
 #include <algorithm>
+#include <functional>
 #include <type_traits>
 #if HAVE_TBB
 # include <tbb/enumerable_thread_specific.h>
 #endif
 #include <boost/noncopyable.hpp>
 
+#include <dune/common/exceptions.hh>
+
 #include <dune/stuff/common/type_utils.hh>
 #include <dune/stuff/common/memory.hh>
 #include <dune/stuff/common/parallel/threadmanager.hh>
@@ -23,6 +26,9 @@ namespace Stuff {
 
 
 /** Automatic Storage of non-static, N thread-local values
+ *
+ *  The values are stored contiguously, each in cache lines of its own, so threads working on their values do not
+ *  interfere with each other (no false sharing).
  **/
 template <class ValueImp>
 class FallbackPerThreadValue : public boost::noncopyable {
@@ -32,73 +38,87 @@ public:
 
 private:
   typedef FallbackPerThreadValue<ValueImp> ThisType;
-  typedef std::deque<std::unique_ptr<ValueType>> ContainerType;
+  typedef typename std::remove_const<ValueImp>::type StoredValueType;
+  typedef Common::CacheLinePadded<StoredValueType> SlotType;
+  typedef std::vector<SlotType, Common::AlignedAllocator<SlotType>> ContainerType;
 
 public:
   //! Initialization by copy construction of ValueType
   explicit FallbackPerThreadValue( ConstValueType& value )
-    : values_( threadManager().max_threads())
-  {
-    std::generate(values_.begin(), values_.end(),
-                  [=](){return Common::make_unique<ValueType>(value);});
-  }
+    : values_( threadManager().max_threads(), SlotType(value) )
+  {}
 
   //! Initialization by in-place construction ValueType with \param ctor_args
   template < class... InitTypes >
   explicit FallbackPerThreadValue( InitTypes&& ...ctor_args )
-    : values_( threadManager().max_threads() )
-  {
-#if __GNUC__
-    // cannot unpack in lambda due to https://gcc.gnu.org/bugzilla/show_bug.cgi?id=47226
-    ValueType v(ctor_args...);
-    std::generate(values_.begin(), values_.end(),
-                  [&](){return Common::make_unique<ValueType>(v);});
-#else
-    std::generate(values_.begin(), values_.end(),
-                  [&](){return Common::make_unique<ValueType>(ctor_args...);});
-#endif
-  }
+    : values_( threadManager().max_threads(), SlotType(StoredValueType(ctor_args...)) )
+  {}
 
   ThisType& operator = (ConstValueType&& value) {
-    std::generate(values_.begin(), values_.end(), [=](){return Common::make_unique<ValueType>(value);});
+    values_ = ContainerType(values_.size(), SlotType(value));
     return *this;
   }
 
   operator ValueType() const { return this->operator *(); }
 
   ValueType& operator * () {
-    return *values_[threadManager().thread()];
+    return values_[slot()].value;
   }
 
   ConstValueType& operator * () const {
-    return *values_[threadManager().thread()];
+    return values_[slot()].value;
   }
 
   ValueType* operator -> () {
-    return values_[threadManager().thread()].get();
+    return &values_[slot()].value;
   }
 
   ConstValueType* operator -> () const {
-    return values_[threadManager().thread()].get();
+    return &values_[slot()].value;
   }
 
   template <class BinaryOperation>
-  ValueType accumulate(ValueType init, BinaryOperation op) const {
-    typedef const typename ContainerType::value_type ptr;
-    auto l = [&](ConstValueType& a, ptr& b){return op(a, *b);};
-    return std::accumulate(values_.begin(), values_.end(), init, l);
+  StoredValueType accumulate(StoredValueType init, BinaryOperation op) const {
+    for (const auto& slot : values_)
+      init = op(init, slot.value);
+    return init;
+  }
+
+  StoredValueType sum() const {
+    return accumulate(StoredValueType(0), std::plus<StoredValueType>());
+  }
+
+  //! calls func(value) for each thread's value
+  template <class UnaryFunction>
+  void combine_each(UnaryFunction func) {
+    for (auto& slot : values_)
+      func(static_cast<ValueType&>(slot.value));
   }
 
-  ValueType sum() const {
-    return accumulate(ValueType(0), std::plus<ValueType>());
+  template <class UnaryFunction>
+  void combine_each(UnaryFunction func) const {
+    for (const auto& slot : values_)
+      func(static_cast<ConstValueType&>(slot.value));
   }
 
 private:
+  //! the calling thread's index into values_, which only has room for max_threads() at construction time
+  size_t slot() const {
+    const auto index = threadManager().thread();
+    if (index >= values_.size())
+      DUNE_THROW(InvalidStateException,
+                 "Thread index " << index << " exceeds the " << values_.size() << " values of this FallbackPerThreadValue, "
+                 << "more distinct threads than slots are in use!");
+    return index;
+  }
+
    ContainerType values_;
 };
 
 #if HAVE_TBB
 /** Automatic Storage of non-static, N thread-local values
+ *
+ *  The values are stored in place, tbb::enumerable_thread_specific pads each of them to a cache line.
  **/
 template <class ValueImp>
 class TBBPerThreadValue : public boost::noncopyable {
@@ -108,12 +128,13 @@ public:
 
 private:
   typedef TBBPerThreadValue<ValueImp> ThisType;
-  typedef tbb::enumerable_thread_specific<std::unique_ptr<ValueType>> ContainerType;
+  typedef typename std::remove_const<ValueImp>::type StoredValueType;
+  typedef tbb::enumerable_thread_specific<StoredValueType> ContainerType;
 
 public:
   //! Initialization by copy construction of ValueType
   explicit TBBPerThreadValue( ValueType value )
-    : values_(new ContainerType([=](){return Common::make_unique<ValueType>(value);}))
+    : values_(new ContainerType([=](){return StoredValueType(value);}))
   {}
 
   //! Initialization by in-place construction ValueType with \param ctor_args
@@ -123,42 +144,55 @@ public:
   // cannot unpack in lambda due to https://gcc.gnu.org/bugzilla/show_bug.cgi?id=47226
     : TBBPerThreadValue(ValueType(ctor_args...))
 #else
-    : values_(new ContainerType([=](){return Common::make_unique<ValueType>(ctor_args...);}))
+    : values_(new ContainerType([=](){return StoredValueType(ctor_args...);}))
 #endif
   {}
 
   ThisType& operator = (ValueType&& value) {
-    values_ = Common::make_unique<ContainerType>([=](){return Common::make_unique<ValueType>(value);});
+    values_ = Common::make_unique<ContainerType>([=](){return StoredValueType(value);});
     return *this;
   }
 
   operator ValueImp() const { return this->operator *(); }
 
   ValueType& operator * () {
-    return *values_->local();
+    return values_->local();
   }
 
   ConstValueType& operator * () const {
-    return *values_->local();
+    return values_->local();
   }
 
   ValueType* operator -> () {
-    return values_->local().get();
+    return &values_->local();
   }
 
   ConstValueType* operator -> () const {
-    return values_->local().get();
+    return &values_->local();
   }
 
   template <class BinaryOperation>
-  ValueType accumulate(ValueType init, BinaryOperation op) const {
-    typedef const typename ContainerType::value_type ptr;
-    auto l = [&](ConstValueType& a, ptr& b){return op(a, *b);};
-    return std::accumulate(values_->begin(), values_->end(), init, l);
+  StoredValueType accumulate(StoredValueType init, BinaryOperation op) const {
+    for (const auto& value : *values_)
+      init = op(init, value);
+    return init;
+  }
+
+  StoredValueType sum() const {
+    return accumulate(StoredValueType(), std::plus<StoredValueType>());
+  }
+
+  //! calls func(value) for each thread's value
+  template <class UnaryFunction>
+  void combine_each(UnaryFunction func) {
+    for (auto& value : *values_)
+      func(static_cast<ValueType&>(value));
   }
 
-  ValueType sum() const {
-    return accumulate(ValueType(), std::plus<ValueType>());
+  template <class UnaryFunction>
+  void combine_each(UnaryFunction func) const {
+    for (const auto& value : *values_)
+      func(static_cast<ConstValueType&>(value));
   }
 
 private:
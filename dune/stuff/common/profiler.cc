@@ -39,6 +39,32 @@
 
 #include <map>
 #include <string>
+#include <limits>
+#include <iterator>
+#include <set>
+#include <array>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <sstream>
+
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+#endif
+#ifdef __unix__
+# include <unistd.h>
+# include <poll.h>
+# include <sys/resource.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/un.h>
+#endif
+#include <functional>
 
 #include <dune/stuff/common/disable_warnings.hh>
 # include <boost/foreach.hpp>
@@ -49,7 +75,6 @@
 # include <boost/format.hpp>
 # include <boost/date_time/posix_time/posix_time.hpp>
 # include <boost/config.hpp>
-# include <boost/timer/timer.hpp>
 #include <dune/stuff/common/reenable_warnings.hh>
 
 
@@ -57,24 +82,485 @@ namespace Dune {
 namespace Stuff {
 namespace Common {
 
-TimingData::TimingData(const std::string _name)
-  : timer_(new boost::timer::cpu_timer),
-    name(_name)
-{timer_->start();}
+namespace {
+
+//! whether operator new counts allocations, see Profiler::enableAllocationTracking()
+std::atomic<bool> tracking_allocations(false);
+//! allocations of this thread not yet attributed to a section
+thread_local std::uint64_t pending_allocations = 0;
+thread_local std::uint64_t pending_bytes = 0;
+
+//! peak resident set size of the process in kilobytes
+long peak_rss()
+{
+#ifdef __unix__
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return usage.ru_maxrss;
+#endif
+  return 0;
+}
+
+Profiler::TimeType milliseconds(const std::chrono::steady_clock::duration& duration)
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+//! the keys of all maps, so that csv columns of different runs line up
+template <class MapType>
+std::set<std::string> union_of_keys(const std::vector<MapType>& maps)
+{
+  std::set<std::string> keys;
+  for (const auto& map : maps)
+    for (const auto& entry : map)
+      keys.insert(entry.first);
+  return keys;
+}
+
+#ifdef __unix__
+//! removes path if it is a socket (e.g. left behind by a previous run), any other file is kept
+void unlink_socket(const std::string& path)
+{
+  struct stat status;
+  if (lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+    unlink(path.c_str());
+}
+#endif // __unix__
+
+} // namespace
+
+Profiler::SectionTimer::SectionTimer()
+  : elapsed(ClockType::duration::zero())
+  , total(ClockType::duration::zero())
+  , calls(0)
+  , running(false)
+  , counting(false)
+{
+  counters_start.fill(0);
+  counters.fill(0);
+}
+
+Profiler::Allocations::Allocations()
+  : count(0)
+  , bytes(0)
+  , peak_rss(0)
+{}
 
-void TimingData::stop() {
-  timer_->stop();
+Profiler::CounterGroup::CounterGroup()
+  : opened(false)
+{}
+
+Profiler::CounterGroup::CounterGroup(const CounterGroup& /*other*/)
+  : opened(false)
+{}
+
+Profiler::CounterGroup::~CounterGroup()
+{
+#ifdef __linux__
+  for (const auto fd : fds)
+    ::close(fd);
+#endif
 }
 
-TimingData::DeltaType TimingData::delta() const
+bool Profiler::CounterGroup::open()
+{
+  if (opened)
+    return !fds.empty();
+  opened = true;
+#ifdef __linux__
+  static const std::array<std::uint64_t, num_counters> configs = {{PERF_COUNT_HW_CPU_CYCLES,
+                                                                   PERF_COUNT_HW_INSTRUCTIONS,
+                                                                   PERF_COUNT_HW_CACHE_REFERENCES,
+                                                                   PERF_COUNT_HW_CACHE_MISSES,
+                                                                   PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+                                                                   PERF_COUNT_HW_BRANCH_MISSES}};
+  for (int ii = 0; ii < num_counters; ++ii) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[ii];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // count the calling thread on any cpu
+    const int fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, fds.empty() ? -1 : fds[0], 0));
+    if (fd < 0) {
+      // without the leader (cycles) there is no group, other events are optional
+      if (fds.empty())
+        return false;
+      continue;
+    }
+    fds.push_back(fd);
+    events.push_back(ii);
+  }
+  return true;
+#else // __linux__
+  return false;
+#endif // __linux__
+} // ... open()
+
+bool Profiler::CounterGroup::read(Counters& values) const
+{
+  values.fill(0);
+#ifdef __linux__
+  if (fds.empty())
+    return false;
+  // nr, time_enabled, time_running, values
+  std::array<std::uint64_t, 3 + num_counters> buffer;
+  const auto bytes = ::read(fds[0], buffer.data(), sizeof(buffer));
+  if (bytes < ssize_t(3 * sizeof(std::uint64_t)))
+    return false;
+  const auto num_values = std::min(std::size_t(buffer[0]), events.size());
+  const double scale = (buffer[2] > 0 && buffer[2] < buffer[1]) ? double(buffer[1]) / double(buffer[2]) : 1.;
+  for (std::size_t ii = 0; ii < num_values; ++ii)
+    values[events[ii]] = std::uint64_t(double(buffer[3 + ii]) * scale);
+  return true;
+#else // __linux__
+  return false;
+#endif // __linux__
+} // ... read(...)
+
+Profiler::SectionHandle Profiler::registerSection(const std::string section_name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = section_handles_.find(section_name);
+  if (it != section_handles_.end())
+    return it->second;
+  const SectionHandle section = section_names_.size();
+  section_names_.push_back(section_name);
+  section_handles_[section_name] = section;
+  return section;
+}
+
+std::string Profiler::sectionName(const SectionHandle section) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (section >= section_names_.size())
+    DUNE_THROW(Dune::RangeError, "unknown section handle " << section);
+  return section_names_[section];
+}
+
+Profiler::CallNode::CallNode(const SectionHandle sec, const std::size_t par)
+  : section(sec)
+  , parent(par)
+  , inclusive(ClockType::duration::zero())
+  , calls(0)
+{}
+
+Profiler::RunningSections::RunningSections()
+  : count(0)
+{}
+
+Profiler::RunningSections::RunningSections(const RunningSections& /*other*/)
+  : count(0)
+{}
+
+Profiler::ThreadData::ThreadData()
+  : call_tree(1, CallNode(std::numeric_limits<SectionHandle>::max(), 0))
+  , dropped_events(0)
+  , thread(0)
+  , busy(ClockType::duration::zero())
+{}
+
+std::size_t Profiler::callChild(CallTree& tree, const std::size_t parent, const SectionHandle section)
+{
+  for (const auto child : tree[parent].children)
+    if (tree[child].section == section)
+      return child;
+  tree.emplace_back(section, parent);
+  tree[parent].children.push_back(tree.size() - 1);
+  return tree.size() - 1;
+}
+
+void Profiler::startTiming(const SectionHandle section)
+{
+  auto& data = *thread_data_;
+  attributeAllocations(data);
+  if (section >= data.timers.size())
+    data.timers.resize(section + 1);
+  auto& timer = data.timers[section];
+  if (timer.running)
+    return;
+  DSC_LIKWID_BEGIN_SECTION(sectionName(section))
+  const auto parent = data.call_stack.empty() ? 0 : data.call_stack.back();
+  data.call_stack.push_back(callChild(data.call_tree, parent, section));
+  data.running.count.store(data.call_stack.size(), std::memory_order_release);
+  timer.running = true;
+  ++timer.calls;
+  timer.counting = counting_.load(std::memory_order_relaxed)
+                   && data.counter_group.open()
+                   && data.counter_group.read(timer.counters_start);
+  // the allocations of the profiler itself are not counted
+  pending_allocations = 0;
+  pending_bytes = 0;
+  timer.start = ClockType::now();
+} // startTiming
+
+long Profiler::stopTiming(const SectionHandle section)
+{
+  const auto now = ClockType::now();
+  auto& data = *thread_data_;
+  if (section >= data.timers.size() || data.timers[section].calls == 0)
+    DUNE_THROW(Dune::RangeError, "trying to stop timer " << sectionName(section) << " that wasn't started\n");
+  auto& timer = data.timers[section];
+  if (!timer.running)
+    return 0;
+  attributeAllocations(data);
+  if (tracking_allocations.load(std::memory_order_relaxed))
+    timer.allocations.peak_rss = std::max(timer.allocations.peak_rss, peak_rss());
+  Counters counters_stop;
+  if (timer.counting && data.counter_group.read(counters_stop)) {
+    for (int ii = 0; ii < num_counters; ++ii)
+      if (counters_stop[ii] > timer.counters_start[ii])
+        timer.counters[ii] += counters_stop[ii] - timer.counters_start[ii];
+  }
+  DSC_LIKWID_END_SECTION(sectionName(section))
+  timer.running = false;
+  const auto delta = now - timer.start;
+  timer.elapsed += delta;
+  timer.total += delta;
+  // usually the innermost section, but sections may also be stopped out of order
+  for (auto it = data.call_stack.rbegin(); it != data.call_stack.rend(); ++it) {
+    auto& node = data.call_tree[*it];
+    if (node.section == section) {
+      node.inclusive += delta;
+      ++node.calls;
+      data.call_stack.erase(std::next(it).base());
+      if (data.call_stack.empty())
+        data.busy += delta;
+      break;
+    }
+  }
+  if (publishing_.load(std::memory_order_relaxed) && now - data.published >= metrics_interval_)
+    publishMetrics(data, now);
+  pending_allocations = 0;
+  pending_bytes = 0;
+  if (tracing_.load(std::memory_order_relaxed)) {
+    if (data.trace.capacity() == 0) {
+      data.trace.reserve(trace_capacity_.load(std::memory_order_relaxed));
+      data.thread = threadManager().thread();
+    }
+    if (data.trace.size() < data.trace.capacity())
+      data.trace.push_back({section, timer.start, now});
+    else
+      ++data.dropped_events;
+  }
+  data.running.count.store(data.call_stack.size(), std::memory_order_release);
+  return long(milliseconds(delta));
+} // stopTiming
+
+void Profiler::checkNoSectionsRunning(const std::string& caller) const
+{
+  const ThreadData* const own = &*thread_data_;
+  thread_data_.combine_each([&](const ThreadData& data) {
+    if (&data != own && data.running.count.load(std::memory_order_acquire) > 0)
+      DUNE_THROW(Dune::InvalidStateException,
+                 caller << " must not be called while a section is running on another thread");
+  });
+} // checkNoSectionsRunning
+
+Profiler::CallTree Profiler::callTree() const
+{
+  CallTree merged(1, CallNode(std::numeric_limits<SectionHandle>::max(), 0));
+  thread_data_.combine_each([&](const ThreadData& data) {
+    // depth first, pairs of (node in data.call_tree, corresponding node in merged)
+    std::vector<std::pair<std::size_t, std::size_t>> todo(1, std::make_pair(0, 0));
+    while (!todo.empty()) {
+      const auto nodes = todo.back();
+      todo.pop_back();
+      for (const auto child : data.call_tree[nodes.first].children) {
+        const auto& node = data.call_tree[child];
+        const auto merged_child = callChild(merged, nodes.second, node.section);
+        merged[merged_child].inclusive += node.inclusive;
+        merged[merged_child].calls += node.calls;
+        todo.emplace_back(child, merged_child);
+      }
+    }
+  });
+  return merged;
+} // callTree
+
+Profiler::Datamap Profiler::currentData() const
+{
+  checkNoSectionsRunning("currentData()");
+  const auto now = ClockType::now();
+  std::vector<ClockType::duration> sum;
+  std::vector<ClockType::duration> max;
+  std::vector<long> threads;
+  thread_data_.combine_each([&](const ThreadData& thread_data) {
+    const auto& timers = thread_data.timers;
+    if (timers.size() > sum.size()) {
+      sum.resize(timers.size(), ClockType::duration::zero());
+      max.resize(timers.size(), ClockType::duration::zero());
+      threads.resize(timers.size(), 0);
+    }
+    for (size_t section = 0; section < timers.size(); ++section) {
+      const auto& timer = timers[section];
+      if (!timer.running && timer.elapsed == ClockType::duration::zero())
+        continue;
+      const auto elapsed = timer.running ? timer.elapsed + (now - timer.start) : timer.elapsed;
+      sum[section] += elapsed;
+      max[section] = std::max(max[section], elapsed);
+      ++threads[section];
+    }
+  });
+  std::lock_guard<std::mutex> lock(mutex_);
+  Datamap data;
+  for (size_t section = 0; section < threads.size(); ++section)
+    if (threads[section] > 0)
+      data[section_names_[section]] = {{milliseconds(sum[section] / threads[section]),
+                                        milliseconds(max[section]), 0, 0}};
+  return data;
+} // currentData
+
+Profiler::DatamapVector Profiler::allData() const
 {
-    const auto scale = 1.0 / double(boost::timer::nanosecond_type(1e6));
-    const auto elapsed = timer_->elapsed();
-    const auto cast = [=](double var) { return static_cast<typename TimingData::DeltaType::value_type>(var); };
-    return {{cast((elapsed.user + elapsed.system) * scale/ double(threadManager().current_threads())),
-            cast(elapsed.wall * scale),
-            cast(elapsed.user * scale),
-            cast(elapsed.system * scale)}};
+  auto data = datamaps_;
+  if (current_run_number_ >= data.size())
+    data.resize(current_run_number_ + 1);
+  data[current_run_number_] = currentData();
+  return data;
+}
+
+Profiler::CounterMap Profiler::currentCounters() const
+{
+  std::vector<Counters> sums;
+  thread_data_.combine_each([&](const ThreadData& thread_data) {
+    const auto& timers = thread_data.timers;
+    if (timers.size() > sums.size()) {
+      Counters zero;
+      zero.fill(0);
+      sums.resize(timers.size(), zero);
+    }
+    for (size_t section = 0; section < timers.size(); ++section)
+      for (int ii = 0; ii < num_counters; ++ii)
+        sums[section][ii] += timers[section].counters[ii];
+  });
+  std::lock_guard<std::mutex> lock(mutex_);
+  CounterMap counters;
+  for (size_t section = 0; section < sums.size(); ++section)
+    if (sums[section][cycles] > 0)
+      counters[section_names_[section]] = sums[section];
+  return counters;
+} // currentCounters
+
+std::vector<Profiler::CounterMap> Profiler::allCounters() const
+{
+  // as many runs as allData()
+  auto counters = counter_maps_;
+  counters.resize(std::max(datamaps_.size(), current_run_number_ + 1));
+  counters[current_run_number_] = currentCounters();
+  return counters;
+}
+
+void Profiler::outputCounterRatios(const CounterMap& counters, const std::set<std::string>& sections,
+                                   std::ostream& header, std::ostream& values) const
+{
+  const auto ratio = [](const std::uint64_t num, const std::uint64_t denom) {
+    return denom > 0 ? double(num) / double(denom) : 0.;
+  };
+  for (const auto& section : sections) {
+    header << csv_sep_ << section << "_ipc"
+           << csv_sep_ << section << "_cache_miss_rate"
+           << csv_sep_ << section << "_branch_miss_rate";
+    const auto counts = counters.find(section);
+    if (counts == counters.end()) {
+      values << csv_sep_ << csv_sep_ << csv_sep_;
+      continue;
+    }
+    values << csv_sep_ << ratio(counts->second[instructions], counts->second[cycles])
+           << csv_sep_ << ratio(counts->second[cache_misses], counts->second[cache_references])
+           << csv_sep_ << ratio(counts->second[branch_misses], counts->second[branches]);
+  }
+} // outputCounterRatios
+
+void Profiler::attributeAllocations(ThreadData& data)
+{
+  if (pending_allocations == 0)
+    return;
+  if (!data.call_stack.empty()) {
+    auto& allocations = data.timers[data.call_tree[data.call_stack.back()].section].allocations;
+    allocations.count += pending_allocations;
+    allocations.bytes += pending_bytes;
+  }
+  pending_allocations = 0;
+  pending_bytes = 0;
+} // attributeAllocations
+
+Profiler::AllocationMap Profiler::currentAllocations() const
+{
+  std::vector<Allocations> sums;
+  thread_data_.combine_each([&](const ThreadData& thread_data) {
+    const auto& timers = thread_data.timers;
+    if (timers.size() > sums.size())
+      sums.resize(timers.size());
+    for (size_t section = 0; section < timers.size(); ++section) {
+      const auto& allocations = timers[section].allocations;
+      sums[section].count += allocations.count;
+      sums[section].bytes += allocations.bytes;
+      sums[section].peak_rss = std::max(sums[section].peak_rss, allocations.peak_rss);
+    }
+  });
+  std::lock_guard<std::mutex> lock(mutex_);
+  AllocationMap allocations;
+  for (size_t section = 0; section < sums.size(); ++section)
+    if (sums[section].count > 0 || sums[section].peak_rss > 0)
+      allocations[section_names_[section]] = sums[section];
+  return allocations;
+} // currentAllocations
+
+std::vector<Profiler::AllocationMap> Profiler::allAllocations() const
+{
+  // as many runs as allData()
+  auto allocations = allocation_maps_;
+  allocations.resize(std::max(datamaps_.size(), current_run_number_ + 1));
+  allocations[current_run_number_] = currentAllocations();
+  return allocations;
+}
+
+void Profiler::outputAllocations(const AllocationMap& allocations, const std::set<std::string>& sections,
+                                 std::ostream& header, std::ostream& values) const
+{
+  for (const auto& section : sections) {
+    header << csv_sep_ << section << "_allocations"
+           << csv_sep_ << section << "_allocated_bytes"
+           << csv_sep_ << section << "_peak_rss_kb";
+    const auto allocation = allocations.find(section);
+    if (allocation == allocations.end()) {
+      values << csv_sep_ << csv_sep_ << csv_sep_;
+      continue;
+    }
+    values << csv_sep_ << allocation->second.count
+           << csv_sep_ << allocation->second.bytes
+           << csv_sep_ << allocation->second.peak_rss;
+  }
+} // outputAllocations
+
+bool Profiler::enableAllocationTracking()
+{
+#if DUNE_STUFF_PROFILE_ALLOCATIONS
+  tracking_allocations = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Profiler::disableAllocationTracking()
+{
+  tracking_allocations = false;
+}
+
+bool Profiler::enableCounters()
+{
+  counting_ = true;
+  return thread_data_->counter_group.open();
+}
+
+void Profiler::disableCounters()
+{
+  counting_ = false;
 }
 
 void Profiler::startTiming(const std::string section_name, const size_t i)
@@ -83,10 +569,10 @@ void Profiler::startTiming(const std::string section_name, const size_t i)
     startTiming(section);
 }
 
-long  Profiler::stopTiming(const std::string section_name, const size_t i, const bool use_walltime)
+long  Profiler::stopTiming(const std::string section_name, const size_t i, const bool /*use_walltime*/)
 {
     const std::string section = section_name + toString(i);
-    return stopTiming(section, use_walltime);
+    return stopTiming(section);
 }
 
 long  Profiler::getTiming(const std::string section_name, const size_t i, const bool use_walltime) const
@@ -103,74 +589,46 @@ void Profiler::resetTiming(const std::string section_name, const size_t i)
 
 void Profiler::resetTiming(const std::string section_name)
 {
-    try {
-        stopTiming(section_name);
+  checkNoSectionsRunning("resetTiming()");
+  const auto section = registerSection(section_name);
+  thread_data_.combine_each([&](ThreadData& thread_data) {
+    auto& timers = thread_data.timers;
+    if (section < timers.size()) {
+      timers[section].running = false;
+      timers[section].elapsed = ClockType::duration::zero();
+      timers[section].counters.fill(0);
+      timers[section].allocations = Allocations();
     }
-    catch (Dune::RangeError) {
-        //ok, timer simply wasn't running
-    }
-    Datamap& current_data = datamaps_[current_run_number_];
-    current_data[section_name] = {{0, 0, 0, 0}};
+  });
 }
 
 void Profiler::startTiming(const std::string section_name) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if ( current_run_number_ >= datamaps_.size() )
-  {
-    datamaps_.push_back( Datamap() );
-  }
-
-  const KnownTimersMap::iterator section = known_timers_map_.find(section_name);
-  if ( section != known_timers_map_.end() )
-  {
-    if (section->second.first)     // timer currently running
-      return;
-
-    section->second.first = true;  // set active, start with new
-    section->second.second = TimingData(section_name);
-  } else {
-    // init new section
-    known_timers_map_[section_name] = std::make_pair( true, TimingData(section_name) );
-  }
-  DSC_LIKWID_BEGIN_SECTION(section_name)
+  startTiming(registerSection(section_name));
 } // StartTiming
 
-long Profiler::stopTiming(const std::string section_name, const bool use_walltime) {
-  DSC_LIKWID_END_SECTION(section_name)
-  assert( current_run_number_ < datamaps_.size() );
-  if ( known_timers_map_.find(section_name) == known_timers_map_.end() )
-    DUNE_THROW(Dune::RangeError, "trying to stop timer " << section_name << " that wasn't started\n");
-
-  known_timers_map_[section_name].first = false;//marks as not running
-  TimingData& timing = *(known_timers_map_[section_name].second);
-  timing.stop();
-  const auto delta = timing.delta();
-  Datamap& current_data = datamaps_[current_run_number_];
-  if ( current_data.find(section_name) == current_data.end() )
-    current_data[section_name] = delta;
-  else {
-    for(auto i : valueRange(delta.size()))
-      current_data[section_name][i] += delta[i];
-  }
-  return use_walltime ? delta[1] : delta[0];
+long Profiler::stopTiming(const std::string section_name) {
+  return stopTiming(registerSection(section_name));
+} // StopTiming
+
+long Profiler::stopTiming(const std::string section_name, const bool /*use_walltime*/) {
+  return stopTiming(section_name);
 } // StopTiming
 
 long Profiler::getTiming(const std::string section_name, const bool use_walltime) const {
-  assert( current_run_number_ < datamaps_.size() );
   return getTimingIdx(section_name, current_run_number_, use_walltime);
 }
 
 long Profiler::getTimingIdx(const std::string section_name, const size_t run_number, const bool use_walltime) const {
-  assert( run_number < datamaps_.size() );
-  const Datamap& data = datamaps_[run_number];
+  if (run_number == current_run_number_)
+    checkNoSectionsRunning("getTiming()");
+  const Datamap data = run_number == current_run_number_ ? currentData() : datamaps_.at(run_number);
   Datamap::const_iterator section = data.find(section_name);
   if ( section == data.end() )
   {
-    //timer might still be running
-    const auto& timer_it = known_timers_map_.find(section_name);
-    if (timer_it == known_timers_map_.end())
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (section_handles_.find(section_name) == section_handles_.end())
       DUNE_THROW(Dune::InvalidStateException, "no timer found: " + section_name);
-    return use_walltime ? timer_it->second.second->delta()[1] : timer_it->second.second->delta()[0];
+    return 0;
   }
   return use_walltime ? section->second[1] : section->second[0];
 } // GetTiming
@@ -179,22 +637,120 @@ long Profiler::getTimingIdx(const std::string section_name, const size_t run_num
 void Profiler::reset(const size_t numRuns) {
   if(!(numRuns > 0))
       DUNE_THROW(Dune::RangeError, "preparing the profiler for 0 runs is moronic");
+  checkNoSectionsRunning("reset()");
   datamaps_.clear();
   datamaps_ = DatamapVector( numRuns, Datamap() );
+  counter_maps_.clear();
+  allocation_maps_.clear();
   current_run_number_ = 0;
+  // running timers keep running, the time they have taken so far is discarded with the old data though
+  thread_data_.combine_each([](ThreadData& thread_data) {
+    const auto now = ClockType::now();
+    for (auto& timer : thread_data.timers) {
+      timer.elapsed = ClockType::duration::zero();
+      timer.start = now;
+      timer.counting = false;
+      timer.counters.fill(0);
+      timer.allocations = Allocations();
+    }
+    for (auto& node : thread_data.call_tree) {
+      node.inclusive = ClockType::duration::zero();
+      node.calls = 0;
+    }
+  });
 } // Reset
 
 void Profiler::addCount(const size_t num) {
+  std::lock_guard<std::mutex> lock(mutex_);
   counters_[num] += 1;
 }
 
 void Profiler::nextRun() {
-    //set all known timers to "stopped"
-    for (auto& timer_it : known_timers_map_)
-        timer_it.second.first = false;
+  checkNoSectionsRunning("nextRun()");
+  if (current_run_number_ >= datamaps_.size())
+    datamaps_.resize(current_run_number_ + 1);
+  datamaps_[current_run_number_] = currentData();
+  if (current_run_number_ >= counter_maps_.size())
+    counter_maps_.resize(current_run_number_ + 1);
+  counter_maps_[current_run_number_] = currentCounters();
+  if (current_run_number_ >= allocation_maps_.size())
+    allocation_maps_.resize(current_run_number_ + 1);
+  allocation_maps_[current_run_number_] = currentAllocations();
+  //set all known timers to "stopped"
+  thread_data_.combine_each([](ThreadData& thread_data) {
+    for (auto& timer : thread_data.timers) {
+      timer.running = false;
+      timer.elapsed = ClockType::duration::zero();
+      timer.counters.fill(0);
+      timer.allocations = Allocations();
+    }
+    thread_data.call_stack.clear();
+    thread_data.running.count.store(0, std::memory_order_relaxed);
+  });
   current_run_number_++;
 }
 
+namespace {
+
+struct SampleStatistics
+{
+  double min;
+  double median;
+  double p95;
+  double max;
+  double mean;
+  double stddev;
+  //! number of samples further than 3 scaled median absolute deviations from the median
+  std::size_t outliers;
+};
+
+//! linear interpolation between the closest ranks of sorted
+double percentile(const std::vector<double>& sorted, const double fraction)
+{
+  const double position = fraction * double(sorted.size() - 1);
+  const auto lower = std::size_t(position);
+  if (lower + 1 >= sorted.size())
+    return sorted.back();
+  return sorted[lower] + (position - double(lower)) * (sorted[lower + 1] - sorted[lower]);
+}
+
+SampleStatistics statistics(std::vector<double> samples)
+{
+  SampleStatistics stats = {0, 0, 0, 0, 0, 0, 0};
+  if (samples.empty())
+    return stats;
+  std::sort(samples.begin(), samples.end());
+  const double size = double(samples.size());
+  stats.min = samples.front();
+  stats.max = samples.back();
+  stats.median = percentile(samples, 0.5);
+  stats.p95 = percentile(samples, 0.95);
+  stats.mean = std::accumulate(samples.begin(), samples.end(), 0.) / size;
+  if (samples.size() > 1) {
+    double squares = 0;
+    for (const auto sample : samples)
+      squares += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = std::sqrt(squares / (size - 1));
+  }
+  std::vector<double> deviations;
+  for (const auto sample : samples)
+    deviations.push_back(std::abs(sample - stats.median));
+  std::sort(deviations.begin(), deviations.end());
+  // scaled to be a consistent estimator of the standard deviation for normally distributed samples
+  const double mad = 1.4826 * percentile(deviations, 0.5);
+  for (const auto deviation : deviations)
+    if (deviation > 3 * mad && mad > 0)
+      ++stats.outliers;
+  return stats;
+} // ... statistics(...)
+
+} // namespace
+
+void Profiler::setWarmupRuns(const size_t runs)
+{
+  warmup_runs_ = runs;
+}
+
 void Profiler::outputAveraged(const int refineLevel,
                               const long numDofs,
                               const double scale_factor) const {
@@ -218,33 +774,60 @@ void Profiler::outputAveraged(const int refineLevel,
 
   boost::filesystem::ofstream csv(filename);
 
-  std::map< std::string, long > averages_map;
-  for (const auto& datamap : datamaps_)
+  // for each section the process averaged timings of all runs after the warm-up runs
+  const auto datamaps = allData();
+  std::map< std::string, std::vector< double > > samples_map;
+  for (size_t run = warmup_runs_; run < datamaps.size(); ++run)
   {
-    for (const auto& timing : datamap)
+    for (const auto& timing : datamaps[run])
     {
-      //! this used to be GetTiming( it->second ), which is only valid thru an implicit and wrong conversion..
-      averages_map[timing.first] += getTiming(timing.first);
+      const double clock_count = timing.second[0];
+      samples_map[timing.first].push_back(comm.sum(clock_count) / double(scale_factor * numProce));
     }
   }
 
 // outputs column names
   csv << "refine" << csv_sep_  << "processes" << csv_sep_ << "numDofs" << csv_sep_ << "L1 error" << csv_sep_;
-  for (const auto& avg_item : averages_map)
+  for (const auto& samples : samples_map)
+  {
+    csv << samples.first << csv_sep_;
+  }
+  csv << "Speedup (total)" << csv_sep_ << "Speedup (ohne Solver)";
+  // hardware counter ratios over all runs, if any
+  CounterMap counters;
+  for (const auto& run_counters : allCounters())
+    for (const auto& section : run_counters)
+      for (int ii = 0; ii < num_counters; ++ii)
+        counters[section.first][ii] += section.second[ii];
+  std::stringstream counter_values;
+  outputCounterRatios(counters, union_of_keys(std::vector<CounterMap>(1, counters)), csv, counter_values);
+  // statistics over the runs
+  csv << csv_sep_ << "runs" << csv_sep_ << "warmup runs";
+  for (const auto& samples : samples_map)
   {
-    csv << avg_item.first << csv_sep_;
+    for (const auto column : {"_min", "_median", "_p95", "_max", "_stddev", "_outliers"})
+      csv << csv_sep_ << samples.first << column;
   }
-  csv << "Speedup (total)" << csv_sep_ << "Speedup (ohne Solver)" << std::endl;
+  csv << std::endl;
 
 // outputs column values
   csv << refineLevel << csv_sep_ << comm.size() << csv_sep_ << numDofs << csv_sep_ << 0 << csv_sep_;
-  for (const auto& avg_item : averages_map)
+  for (const auto& samples : samples_map)
   {
-    long clock_count = avg_item.second;
-    clock_count = long( comm.sum(clock_count) / double(scale_factor * numProce) );
-    csv << clock_count / double(datamaps_.size()) << csv_sep_;
+    csv << statistics(samples.second).mean << csv_sep_;
   }
-  csv << "=I$2/I2" << csv_sep_ << "=SUM(E$2:G$2)/SUM(E2:G2)" << std::endl;
+  csv << "=I$2/I2" << csv_sep_ << "=SUM(E$2:G$2)/SUM(E2:G2)" << counter_values.str();
+  size_t runs = 0;
+  for (const auto& samples : samples_map)
+    runs = std::max(runs, samples.second.size());
+  csv << csv_sep_ << runs << csv_sep_ << warmup_runs_;
+  for (const auto& samples : samples_map)
+  {
+    const auto stats = statistics(samples.second);
+    csv << csv_sep_ << stats.min << csv_sep_ << stats.median << csv_sep_ << stats.p95 << csv_sep_ << stats.max
+        << csv_sep_ << stats.stddev << csv_sep_ << stats.outliers;
+  }
+  csv << std::endl;
   csv.close();
 } // OutputAveraged
 
@@ -269,7 +852,8 @@ void Profiler::outputTimings(const std::string csv) const
 
 void Profiler::outputTimingsAll(std::ostream& out) const
 {
-  if (datamaps_.size() < 1)
+  const auto datamaps = allData();
+  if (datamaps.size() < 1)
     return;
   //csv header:
   const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
@@ -277,34 +861,24 @@ void Profiler::outputTimingsAll(std::ostream& out) const
   std::stringstream stash;
 
   stash << "run" << csv_sep_ << "threads" << csv_sep_ << "ranks";
-  for (const auto& section : datamaps_[0]) {
-    stash << csv_sep_ << section.first << "_avg_mix" << csv_sep_ << section.first << "_max_mix"
-          << csv_sep_ << section.first << "_avg_usr" << csv_sep_ << section.first << "_max_usr"
-          << csv_sep_ << section.first << "_avg_wall" << csv_sep_ << section.first << "_max_wall"
-          << csv_sep_ << section.first << "_avg_sys" << csv_sep_ << section.first << "_max_sys";
+  for (const auto& section : datamaps[0]) {
+    stash << csv_sep_ << section.first << "_avg_per_thread" << csv_sep_ << section.first << "_max_per_thread"
+          << csv_sep_ << section.first << "_avg_wall" << csv_sep_ << section.first << "_max_wall";
   }
   int i = 0;
   const auto weight = 1 / double(comm.size());
-  for (const auto& datamap : datamaps_) {
+  for (const auto& datamap : datamaps) {
     stash << std::endl << i++ << csv_sep_ << DS::threadManager().max_threads() << csv_sep_ << comm.size();
     for (const auto& section : datamap) {
       const auto timings = section.second;
+      auto per_thread = timings[0];
       auto wall = timings[1];
-      auto usr = timings[2];
-      auto sys = timings[3];
-      auto mix = timings[0];
+      const auto per_thread_sum = comm.sum(per_thread);
+      const auto per_thread_max = comm.max(per_thread);
       const auto wall_sum = comm.sum(wall);
       const auto wall_max = comm.max(wall);
-      const auto usr_sum = comm.sum(usr);
-      const auto usr_max = comm.max(usr);
-      const auto sys_sum = comm.sum(sys);
-      const auto sys_max = comm.max(sys);
-      const auto mix_sum = comm.sum(mix);
-      const auto mix_max = comm.max(mix);
-      stash << csv_sep_ << mix_sum * weight << csv_sep_ << mix_max
-            << csv_sep_ << usr_sum * weight << csv_sep_ << usr_max
-            << csv_sep_ << wall_sum * weight << csv_sep_ << wall_max
-            << csv_sep_ << sys_sum * weight << csv_sep_ << sys_max;
+      stash << csv_sep_ << per_thread_sum * weight << csv_sep_ << per_thread_max
+            << csv_sep_ << wall_sum * weight << csv_sep_ << wall_max;
     }
   }
   stash << std::endl;
@@ -314,25 +888,460 @@ void Profiler::outputTimingsAll(std::ostream& out) const
 
 void Profiler::outputTimings(std::ostream& out) const
 {
-  if (datamaps_.size() < 1)
+  const auto datamaps = allData();
+  if (datamaps.size() < 1)
     return;
+  const auto counters = allCounters();
+  const auto allocations = allAllocations();
+  // the sections may differ between runs, a run lacking a section gets empty cells
+  const auto sections = union_of_keys(datamaps);
+  const auto counter_sections = union_of_keys(counters);
+  const auto allocation_sections = union_of_keys(allocations);
+  std::stringstream discard;
   //csv header:
   out << "run";
-  for (const auto& section : datamaps_[0]) {
-    out << csv_sep_ << section.first;
+  for (const auto& section : sections) {
+    out << csv_sep_ << section;
   }
+  outputCounterRatios(CounterMap(), counter_sections, out, discard);
+  outputAllocations(AllocationMap(), allocation_sections, out, discard);
   size_t i = 0;
-  for (const auto& datamap : datamaps_) {
+  for (const auto& datamap : datamaps) {
     out << std::endl << i;
-    for (const auto& section : datamap) {
-      out << csv_sep_ << section.second[0];
+    for (const auto& section : sections) {
+      const auto timing = datamap.find(section);
+      out << csv_sep_;
+      if (timing != datamap.end())
+        out << timing->second[0];
     }
+    outputCounterRatios(counters[i], counter_sections, discard, out);
+    outputAllocations(allocations[i], allocation_sections, discard, out);
     out << std::endl;
+    ++i;
+  }
+}
+
+namespace {
+
+std::string json_escaped(const std::string& str)
+{
+  std::string ret;
+  for (const char c : str) {
+    if (c == '"' || c == '\\')
+      ret += '\\';
+    ret += c;
+  }
+  return ret;
+}
+
+} // namespace
+
+void Profiler::outputCallTreeCollapsed(std::ostream& out) const
+{
+  const auto tree = callTree();
+  std::vector<std::string> paths(tree.size());
+  // parents are always stored before their children
+  for (size_t ii = 1; ii < tree.size(); ++ii) {
+    const auto& node = tree[ii];
+    const auto name = sectionName(node.section);
+    paths[ii] = node.parent == 0 ? name : paths[node.parent] + ";" + name;
+    if (node.calls == 0)
+      continue;
+    auto exclusive = node.inclusive;
+    for (const auto child : node.children)
+      exclusive -= tree[child].inclusive;
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(exclusive).count();
+    if (micros > 0)
+      out << paths[ii] << " " << micros << "\n";
   }
+} // outputCallTreeCollapsed
+
+void Profiler::outputCallTreeJson(std::ostream& out) const
+{
+  const auto tree = callTree();
+  const auto ms = [](const ClockType::duration& duration) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(duration).count();
+  };
+  // nodes which have been called themselves or in their subtree, children are always stored after their parents
+  std::vector<bool> called(tree.size(), false);
+  for (size_t ii = tree.size(); ii > 1; --ii)
+    if (tree[ii - 1].calls > 0 || called[ii - 1])
+      called[ii - 1] = called[tree[ii - 1].parent] = true;
+  std::function<void(std::size_t, std::string)> print = [&](const std::size_t ii, const std::string indent) {
+    const auto& node = tree[ii];
+    auto inclusive = node.inclusive;
+    auto exclusive = node.inclusive;
+    if (ii == 0)
+      inclusive = exclusive = ClockType::duration::zero();
+    for (const auto child : node.children) {
+      if (ii == 0)
+        inclusive += tree[child].inclusive;
+      else
+        exclusive -= tree[child].inclusive;
+    }
+    out << indent << "{\"name\": \"" << (ii == 0 ? std::string("root") : json_escaped(sectionName(node.section)))
+        << "\", \"calls\": " << node.calls
+        << ", \"inclusive_ms\": " << ms(inclusive) << ", \"exclusive_ms\": " << ms(exclusive)
+        << ", \"children\": [";
+    bool first = true;
+    for (const auto child : node.children) {
+      if (!called[child])
+        continue;
+      out << (first ? "\n" : ",\n");
+      first = false;
+      print(child, indent + "  ");
+    }
+    out << (first ? "" : "\n" + indent) << "]}";
+  };
+  print(0, "");
+  out << std::endl;
+} // outputCallTreeJson
+
+void Profiler::outputCallTree(const std::string filename) const
+{
+  boost::filesystem::path dir(output_dir_);
+  boost::filesystem::ofstream folded(dir / (filename + ".folded"));
+  outputCallTreeCollapsed(folded);
+  boost::filesystem::ofstream json(dir / (filename + ".json"));
+  outputCallTreeJson(json);
 }
 
+void Profiler::enableTracing(const std::string filename, const std::size_t capacity)
+{
+  if (!tracing_) {
+    // the rank is queried here, disableTracing() may be called late in the program
+    const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+    trace_filename_ = (comm.size() > 1 && !filename.empty())
+                    ? (boost::format("p%08d_%s") % comm.rank() % filename).str() : filename;
+    trace_capacity_ = std::max(std::size_t(1), capacity);
+    if (trace_begin_ == ClockType::time_point())
+      trace_begin_ = ClockType::now();
+  }
+  tracing_ = true;
+}
+
+void Profiler::disableTracing()
+{
+  if (!tracing_.exchange(false) || trace_filename_.empty())
+    return;
+  boost::filesystem::ofstream trace(boost::filesystem::path(output_dir_) / trace_filename_);
+  outputTrace(trace);
+}
+
+void Profiler::outputTrace(std::ostream& out) const
+{
+  const auto rank = Dune::MPIHelper::getCollectiveCommunication().rank();
+  const auto micros = [&](const ClockType::time_point& time) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(time - trace_begin_).count();
+  };
+  std::vector<std::string> names;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& name : section_names_)
+      names.push_back(json_escaped(name));
+  }
+  std::set<std::size_t> threads;
+  std::size_t dropped = 0;
+  out << "{\"traceEvents\": [";
+  std::string sep = "\n";
+  thread_data_.combine_each([&](const ThreadData& data) {
+    if (data.trace.empty())
+      return;
+    threads.insert(data.thread);
+    dropped += data.dropped_events;
+    for (const auto& event : data.trace) {
+      out << sep << "{\"name\": \"" << names[event.section] << "\", \"ph\": \"X\", \"pid\": " << rank
+          << ", \"tid\": " << data.thread << ", \"ts\": " << micros(event.begin)
+          << ", \"dur\": " << micros(event.end) - micros(event.begin) << "}";
+      sep = ",\n";
+    }
+  });
+  for (const auto thread : threads) {
+    out << sep << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << rank << ", \"tid\": " << thread
+        << ", \"args\": {\"name\": \"thread " << thread << "\"}}";
+    sep = ",\n";
+  }
+  out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": " << dropped << "}}" << std::endl;
+} // outputTrace
+
+void Profiler::publishMetrics(ThreadData& data, const ClockType::time_point now)
+{
+  if (!data.metrics) {
+    data.metrics = std::make_shared<MetricsSnapshot>();
+    data.metrics->thread = threadManager().thread();
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_snapshots_.push_back(data.metrics);
+  }
+  data.published = now;
+  auto& snapshot = *data.metrics;
+  std::lock_guard<std::mutex> lock(snapshot.mutex);
+  snapshot.totals.resize(data.timers.size());
+  snapshot.calls.resize(data.timers.size());
+  for (size_t section = 0; section < data.timers.size(); ++section) {
+    snapshot.totals[section] = data.timers[section].total;
+    snapshot.calls[section] = data.timers[section].calls;
+  }
+  snapshot.busy = data.busy;
+} // publishMetrics
+
+void Profiler::enableMetrics(const std::string target, const MetricsFormat format,
+                             const std::chrono::milliseconds interval)
+{
+  disableMetrics();
+  const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+  metrics_rank_ = comm.rank();
+  metrics_format_ = format;
+  metrics_interval_ = std::max(ClockType::duration(interval), ClockType::duration(std::chrono::milliseconds(1)));
+  const std::string socket_prefix = "unix:";
+  if (target.compare(0, socket_prefix.size(), socket_prefix) == 0) {
+#ifdef __unix__
+    metrics_target_ = target.substr(socket_prefix.size());
+    if (comm.size() > 1)
+      metrics_target_ += (boost::format(".%08d") % metrics_rank_).str();
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (metrics_target_.size() >= sizeof(address.sun_path))
+      DUNE_THROW(Dune::IOError, "socket path '" << metrics_target_ << "' is too long");
+    std::strcpy(address.sun_path, metrics_target_.c_str());
+    metrics_socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (metrics_socket_ < 0)
+      DUNE_THROW(Dune::IOError, "could not create a socket: " << std::strerror(errno));
+    unlink_socket(metrics_target_);
+    if (bind(metrics_socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(metrics_socket_, 16) != 0) {
+      const std::string error = std::strerror(errno);
+      ::close(metrics_socket_);
+      metrics_socket_ = -1;
+      DUNE_THROW(Dune::IOError, "could not listen on '" << metrics_target_ << "': " << error);
+    }
+#else
+    DUNE_THROW(Dune::NotImplemented, "publishing metrics to a socket is only available on unix");
+#endif
+  } else {
+    boost::filesystem::path filename(output_dir_);
+    filename /= comm.size() > 1 ? (boost::format("p%08d_%s") % metrics_rank_ % target).str() : target;
+    metrics_target_ = filename.string();
+  }
+  // the utilization in the first snapshot only accounts for the time from now on
+  std::vector<std::shared_ptr<MetricsSnapshot>> snapshots;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshots = metrics_snapshots_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    metrics_previous_time_ = ClockType::now();
+    metrics_previous_busy_.clear();
+    for (const auto& snapshot : snapshots) {
+      std::lock_guard<std::mutex> snapshot_lock(snapshot->mutex);
+      metrics_previous_busy_[snapshot->thread] += snapshot->busy;
+    }
+  }
+  metrics_stop_ = false;
+  publishing_ = true;
+  metrics_thread_ = std::thread([this]() { runMetrics(); });
+} // enableMetrics
+
+void Profiler::disableMetrics()
+{
+  if (!metrics_thread_.joinable())
+    return;
+  stopMetrics();
+  // stopMetrics() clears the target of a socket
+  if (!metrics_target_.empty())
+    writeMetricsFile();
+} // disableMetrics
+
+void Profiler::stopMetrics()
+{
+  if (!metrics_thread_.joinable())
+    return;
+  publishing_ = false;
+  {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    metrics_stop_ = true;
+  }
+  metrics_condition_.notify_all();
+  metrics_thread_.join();
+#ifdef __unix__
+  if (metrics_socket_ >= 0) {
+    ::close(metrics_socket_);
+    metrics_socket_ = -1;
+    unlink_socket(metrics_target_);
+    metrics_target_.clear();
+  }
+#endif
+} // stopMetrics
+
+void Profiler::runMetrics()
+{
+  while (!metrics_stop_) {
+#ifdef __unix__
+    if (metrics_socket_ >= 0) {
+      // wake up regularly to notice metrics_stop_
+      pollfd listening = {metrics_socket_, POLLIN, 0};
+      if (poll(&listening, 1, 100) <= 0)
+        continue;
+      const int client = accept(metrics_socket_, nullptr, nullptr);
+      if (client < 0)
+        continue;
+      const auto now = ClockType::now();
+      std::ostringstream metrics;
+      advanceMetricsBaseline(now, writeMetrics(metrics, metrics_format_, now, metrics_rank_));
+      const std::string str = metrics.str();
+      for (size_t written = 0; written < str.size();) {
+        const auto sent = send(client, str.data() + written, str.size() - written, MSG_NOSIGNAL);
+        if (sent <= 0)
+          break;
+        written += size_t(sent);
+      }
+      ::close(client);
+      continue;
+    }
+#endif
+    {
+      std::unique_lock<std::mutex> lock(metrics_mutex_);
+      if (metrics_condition_.wait_for(lock, metrics_interval_, [&]() { return metrics_stop_.load(); }))
+        break;
+    }
+    writeMetricsFile();
+  }
+} // runMetrics
+
+void Profiler::writeMetricsFile()
+{
+  const boost::filesystem::path filename(metrics_target_);
+  const boost::filesystem::path tmp_filename(metrics_target_ + ".tmp");
+  const auto now = ClockType::now();
+  {
+    boost::filesystem::ofstream metrics(tmp_filename);
+    advanceMetricsBaseline(now, writeMetrics(metrics, metrics_format_, now, metrics_rank_));
+  }
+  boost::system::error_code error;
+  boost::filesystem::rename(tmp_filename, filename, error);
+} // writeMetricsFile
+
+void Profiler::advanceMetricsBaseline(const ClockType::time_point now,
+                                      std::map<std::size_t, ClockType::duration> busy)
+{
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+  metrics_previous_time_ = now;
+  metrics_previous_busy_ = std::move(busy);
+} // advanceMetricsBaseline
+
+void Profiler::outputMetrics(std::ostream& out, const MetricsFormat format) const
+{
+  writeMetrics(out, format, ClockType::now(), Dune::MPIHelper::getCollectiveCommunication().rank());
+}
+
+std::map<std::size_t, Profiler::ClockType::duration> Profiler::writeMetrics(std::ostream& out,
+                                                                             const MetricsFormat format,
+                                                                             const ClockType::time_point now,
+                                                                             const int rank) const
+{
+  const auto seconds = [](const ClockType::duration& duration) {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+  };
+  std::vector<std::shared_ptr<MetricsSnapshot>> snapshots;
+  std::vector<std::string> names;
+  std::map<size_t, size_t> counts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshots = metrics_snapshots_;
+    names = section_names_;
+    counts = counters_;
+  }
+  std::vector<ClockType::duration> totals(names.size(), ClockType::duration::zero());
+  std::vector<std::size_t> calls(names.size(), 0);
+  std::map<std::size_t, ClockType::duration> busy;
+  for (const auto& snapshot : snapshots) {
+    std::lock_guard<std::mutex> lock(snapshot->mutex);
+    for (size_t section = 0; section < snapshot->totals.size() && section < names.size(); ++section) {
+      totals[section] += snapshot->totals[section];
+      calls[section] += snapshot->calls[section];
+    }
+    busy[snapshot->thread] += snapshot->busy;
+  }
+  std::map<std::size_t, double> utilization;
+  {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    const auto elapsed = seconds(now - metrics_previous_time_);
+    for (const auto& thread : busy) {
+      const auto previous = metrics_previous_busy_.find(thread.first);
+      const auto delta = thread.second
+                         - (previous == metrics_previous_busy_.end() ? ClockType::duration::zero() : previous->second);
+      utilization[thread.first] = elapsed > 0 ? std::min(1., seconds(delta) / elapsed) : 0.;
+    }
+  }
+  if (format == MetricsFormat::json) {
+    out << "{\"rank\": " << rank << ",\n \"sections\": [";
+    std::string sep = "\n  ";
+    for (size_t section = 0; section < names.size(); ++section) {
+      if (calls[section] == 0)
+        continue;
+      out << sep << "{\"name\": \"" << json_escaped(names[section]) << "\", \"seconds\": " << seconds(totals[section])
+          << ", \"calls\": " << calls[section] << "}";
+      sep = ",\n  ";
+    }
+    out << "],\n \"counts\": {";
+    sep = "";
+    for (const auto& count : counts) {
+      out << sep << "\"" << count.first << "\": " << count.second;
+      sep = ", ";
+    }
+    out << "},\n \"threads\": [";
+    sep = "\n  ";
+    for (const auto& thread : busy) {
+      out << sep << "{\"thread\": " << thread.first << ", \"busy_seconds\": " << seconds(thread.second)
+          << ", \"utilization\": " << utilization[thread.first] << "}";
+      sep = ",\n  ";
+    }
+    out << "]}" << std::endl;
+  } else {
+    out << "# HELP dune_stuff_section_seconds_total Time spent in a profiler section, summed over all threads.\n"
+        << "# TYPE dune_stuff_section_seconds_total counter\n";
+    for (size_t section = 0; section < names.size(); ++section)
+      if (calls[section] > 0)
+        out << "dune_stuff_section_seconds_total{rank=\"" << rank << "\",section=\"" << json_escaped(names[section])
+            << "\"} " << seconds(totals[section]) << "\n";
+    out << "# HELP dune_stuff_section_calls_total Calls of a profiler section, summed over all threads.\n"
+        << "# TYPE dune_stuff_section_calls_total counter\n";
+    for (size_t section = 0; section < names.size(); ++section)
+      if (calls[section] > 0)
+        out << "dune_stuff_section_calls_total{rank=\"" << rank << "\",section=\"" << json_escaped(names[section])
+            << "\"} " << calls[section] << "\n";
+    out << "# HELP dune_stuff_count_total Counts of Profiler::addCount().\n"
+        << "# TYPE dune_stuff_count_total counter\n";
+    for (const auto& count : counts)
+      out << "dune_stuff_count_total{rank=\"" << rank << "\",id=\"" << count.first << "\"} " << count.second << "\n";
+    out << "# HELP dune_stuff_thread_busy_seconds_total Time a thread spent in outermost profiler sections.\n"
+        << "# TYPE dune_stuff_thread_busy_seconds_total counter\n";
+    for (const auto& thread : busy)
+      out << "dune_stuff_thread_busy_seconds_total{rank=\"" << rank << "\",thread=\"" << thread.first << "\"} "
+          << seconds(thread.second) << "\n";
+    out << "# HELP dune_stuff_thread_utilization Fraction of the time since the previous snapshot a thread was busy.\n"
+        << "# TYPE dune_stuff_thread_utilization gauge\n";
+    for (const auto& thread : busy)
+      out << "dune_stuff_thread_utilization{rank=\"" << rank << "\",thread=\"" << thread.first << "\"} "
+          << utilization[thread.first] << "\n";
+    out.flush();
+  }
+  return busy;
+} // writeMetrics
+
 Profiler::Profiler()
-  : csv_sep_(",")
+  : thread_data_(ThreadData())
+  , csv_sep_(",")
+  , warmup_runs_(0)
+  , tracing_(false)
+  , trace_capacity_(0)
+  , publishing_(false)
+  , metrics_interval_(ClockType::duration::zero())
+  , metrics_format_(MetricsFormat::prometheus)
+  , metrics_rank_(0)
+  , metrics_socket_(-1)
+  , metrics_stop_(false)
 {
   DSC_LIKWID_INIT;
   reset(1);
@@ -341,6 +1350,8 @@ Profiler::Profiler()
 
 Profiler::~Profiler()
 {
+  // static destruction may run after MPI_Finalize(), see disableMetrics()
+  stopMetrics();
   DSC_LIKWID_CLOSE;
 }
 
@@ -348,12 +1359,91 @@ OutputScopedTiming::OutputScopedTiming(const std::string &section_name, std::ost
   : ScopedTiming(section_name)
   , out_(out) {}
 
+OutputScopedTiming::OutputScopedTiming(const Profiler::SectionHandle section, std::ostream &out)
+  : ScopedTiming(section)
+  , out_(out) {}
+
 OutputScopedTiming::~OutputScopedTiming() {
-  const auto duration = profiler().stopTiming(section_name_);
-  out_ << "Executing " << section_name_ << " took " << duration / 1000.f << "s\n";
+  const auto duration = profiler().stopTiming(section_);
+  out_ << "Executing " << profiler().sectionName(section_) << " took " << duration / 1000.f << "s\n";
 }
 
 
 } // namespace Common
 } // namespace Stuff
 } // namespace Dune
+
+#if DUNE_STUFF_PROFILE_ALLOCATIONS
+
+namespace {
+
+void* counted_allocation(std::size_t size)
+{
+  if (Dune::Stuff::Common::tracking_allocations.load(std::memory_order_relaxed)) {
+    ++Dune::Stuff::Common::pending_allocations;
+    Dune::Stuff::Common::pending_bytes += size;
+  }
+  if (size == 0)
+    size = 1;
+  while (true) {
+    void* ptr = std::malloc(size);
+    if (ptr)
+      return ptr;
+    const auto handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+} // ... counted_allocation(...)
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return counted_allocation(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  try {
+    return counted_allocation(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  try {
+    return counted_allocation(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+#endif // DUNE_STUFF_PROFILE_ALLOCATIONS
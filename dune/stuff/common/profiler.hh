@@ -10,18 +10,29 @@
 # define DUNE_STUFF_DO_PROFILE 0
 #endif
 
+//! replace the global operator new and delete to count allocations, see Profiler::enableAllocationTracking()
+#ifndef DUNE_STUFF_PROFILE_ALLOCATIONS
+# define DUNE_STUFF_PROFILE_ALLOCATIONS 0
+#endif
+
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
-#include <ctime>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <iostream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 
 #include <boost/noncopyable.hpp>
-#include <boost/timer/timer.hpp>
 
 #include <dune/common/unused.hh>
+#include <dune/common/deprecated.hh>
 
 #include <dune/stuff/common/parallel/threadmanager.hh>
 #include <dune/stuff/common/parallel/threadstorage.hh>
@@ -35,27 +46,6 @@ class Profiler;
 //! Stuff::Profiler global instance
 Profiler& profiler();
 
-//! wraps name, start- and end time for one timing section
-struct TimingData
-{
-private:
-  std::shared_ptr<boost::timer::cpu_timer> timer_;
-public:
-  std::string name;
-
-  explicit TimingData(const std::string _name = "blank");
-
-  void stop();
-
-  typedef boost::timer::nanosecond_type TimeType;
-  typedef std::array<TimeType, 4> DeltaType;
-
-  /** \return time elapsed since object construction in milliseconds
-   *  \note since typical resolutions for user+system time are 10-15ms the nanosecond results are scaled accordingly
-   **/
-  DeltaType delta() const;
-};
-
 //! a utility class to time a limited scope of code
 class ScopedTiming;
 
@@ -63,23 +53,159 @@ class ScopedTiming;
    *  - User can set as many (even nested) named sections whose total (=system+user) time will be computed across all program
    * instances.\n
    *  - Provides csv-conform output of process-averaged runtimes.
+   *
+   *  Sections are registered once by name (registerSection()), timing a section by its handle only takes a
+   *  steady_clock stamp in a per-thread slot, without locks or string operations. The evaluation and output methods
+   *  collect the slots of all threads and must not be called concurrently to timings on other threads. This includes
+   *  getTiming(), resetTiming(), reset() and nextRun(), which throw if a section is running on another thread (the
+   *  sections of the calling thread may keep running). Call them between parallel regions, not from within.
+   *  The timings of a section are {average over the threads that timed it, maximum over the threads (wall), 0, 0}
+   *  in milliseconds, user and system times are no longer sampled per section.
+   *  Additionally each thread records the nesting of its sections, see outputCallTreeCollapsed() and
+   *  outputCallTreeJson(). Sections of worker threads are rooted at the first section timed on the respective thread.
    **/
 class Profiler
 {
   friend Profiler& profiler();
 
+public:
+  typedef std::size_t SectionHandle;
+  typedef std::int64_t TimeType;
+  typedef std::array<TimeType, 4> DeltaType;
+
 private:
   Profiler();
   ~Profiler();
 
-  typedef std::map< std::string, std::pair< bool, PerThreadValue<TimingData> > >
-    KnownTimersMap;
-  //! section name -> seconds
-  typedef std::map< std::string, TimingData::DeltaType >
+  typedef std::chrono::steady_clock ClockType;
+  //! hardware events counted per section, see enableCounters()
+  enum CounterIndex { cycles, instructions, cache_references, cache_misses, branches, branch_misses, num_counters };
+  typedef std::array< std::uint64_t, num_counters > Counters;
+  //! see enableAllocationTracking()
+  struct Allocations
+  {
+    Allocations();
+
+    std::uint64_t count;
+    std::uint64_t bytes;
+    //! peak resident set size of the process at the end of a call in kilobytes, maximum over the calls
+    long peak_rss;
+  };
+  //! state of one section on one thread
+  struct SectionTimer
+  {
+    SectionTimer();
+
+    ClockType::time_point start;
+    //! in the current run
+    ClockType::duration elapsed;
+    //! over all runs, not reset by reset() or nextRun()
+    ClockType::duration total;
+    //! over all runs
+    std::size_t calls;
+    bool running;
+    //! whether counters_start has been read at the start of the running call
+    bool counting;
+    Counters counters_start;
+    //! in the current run
+    Counters counters;
+    //! in the current run
+    Allocations allocations;
+  };
+  //! perf_event counter group of the owning thread
+  struct CounterGroup
+  {
+    CounterGroup();
+    //! copies do not share the counters of the original
+    CounterGroup(const CounterGroup& other);
+    CounterGroup& operator=(const CounterGroup& other) = delete;
+    ~CounterGroup();
+
+    //! \return false if the counters are not available, e.g. due to /proc/sys/kernel/perf_event_paranoid
+    bool open();
+    //! current counts scaled for multiplexing, events that could not be opened are 0
+    bool read(Counters& values) const;
+
+    //! fds[0] is the group leader
+    std::vector< int > fds;
+    //! the CounterIndex of each fd
+    std::vector< int > events;
+    bool opened;
+  };
+  //! node of a call tree, node 0 is the (unnamed) root
+  struct CallNode
+  {
+    CallNode(const SectionHandle sec, const std::size_t par);
+
+    SectionHandle section;
+    std::size_t parent;
+    std::vector< std::size_t > children;
+    //! summed over all completed calls
+    ClockType::duration inclusive;
+    std::size_t calls;
+  };
+  typedef std::vector< CallNode > CallTree;
+  //! what a thread last published for the metrics, see enableMetrics()
+  struct MetricsSnapshot
+  {
+    std::mutex mutex;
+    std::size_t thread;
+    //! indexed by SectionHandle
+    std::vector< ClockType::duration > totals;
+    std::vector< std::size_t > calls;
+    ClockType::duration busy;
+  };
+  //! one completed call of a section, see enableTracing()
+  struct TraceEvent
+  {
+    SectionHandle section;
+    ClockType::time_point begin;
+    ClockType::time_point end;
+  };
+  //! number of running sections of a thread, readable by the other threads
+  struct RunningSections
+  {
+    RunningSections();
+    //! copies start without running sections
+    RunningSections(const RunningSections& other);
+
+    std::atomic< std::size_t > count;
+  };
+  //! everything a thread records, only the owning thread resizes or writes
+  struct ThreadData
+  {
+    ThreadData();
+
+    //! indexed by SectionHandle
+    std::vector< SectionTimer > timers;
+    CallTree call_tree;
+    //! call tree nodes of the running sections, innermost last
+    std::vector< std::size_t > call_stack;
+    //! preallocated on the first event of this thread
+    std::vector< TraceEvent > trace;
+    std::size_t dropped_events;
+    std::size_t thread;
+    CounterGroup counter_group;
+    //! time spent in outermost sections
+    ClockType::duration busy;
+    //! created on the first publication of this thread
+    std::shared_ptr< MetricsSnapshot > metrics;
+    ClockType::time_point published;
+    //! call_stack.size(), stored by the owning thread after each startTiming() and stopTiming()
+    RunningSections running;
+  };
+  //! section name -> milliseconds averaged over the threads, maximum over the threads, the other entries are 0
+  typedef std::map< std::string, DeltaType >
     Datamap;
   //! "Run idx" -> Datamap = section name -> seconds
   typedef std::vector< Datamap >
     DatamapVector;
+  //! section name -> counters summed over all threads
+  typedef std::map< std::string, Counters >
+    CounterMap;
+  //! section name -> allocations summed over all threads
+  typedef std::map< std::string, Allocations >
+    AllocationMap;
 
   //! appends int to section name
   long stopTiming(const std::string section_name, const size_t i, const bool use_walltime);
@@ -95,21 +221,93 @@ private:
   //! get runtime of section in run run_number in milliseconds
   long getTimingIdx(const std::string section_name, const size_t run_number, const bool use_walltime) const;
 
+  //! throws if a section is running on any thread but the calling one, see the class documentation
+  void checkNoSectionsRunning(const std::string& caller) const;
+
+  //! the timings of all threads in the current run
+  Datamap currentData() const;
+
+  //! datamaps_ with the current run filled by currentData()
+  DatamapVector allData() const;
+
+  //! the counters of all threads in the current run
+  CounterMap currentCounters() const;
+
+  //! counter_maps_ with the current run filled by currentCounters()
+  std::vector< CounterMap > allCounters() const;
+
+  //! csv header and values of IPC and miss rates for each of sections, empty values for sections without counts
+  void outputCounterRatios(const CounterMap& counters, const std::set< std::string >& sections,
+                           std::ostream& header, std::ostream& values) const;
+
+  //! attributes the allocations of this thread since the last call to its innermost running section
+  static void attributeAllocations(ThreadData& data);
+
+  //! the allocations of all threads in the current run
+  AllocationMap currentAllocations() const;
+
+  //! allocation_maps_ with the current run filled by currentAllocations()
+  std::vector< AllocationMap > allAllocations() const;
+
+  //! csv header and values of the allocation count, bytes and peak RSS for each of sections, empty if not allocating
+  void outputAllocations(const AllocationMap& allocations, const std::set< std::string >& sections,
+                         std::ostream& header, std::ostream& values) const;
+
+  //! \return the child of parent for section, adds it if necessary
+  static std::size_t callChild(CallTree& tree, const std::size_t parent, const SectionHandle section);
+
+  //! the call trees of all threads merged by their paths from the root
+  CallTree callTree() const;
+
+  //! copies the totals of data to its MetricsSnapshot
+  void publishMetrics(ThreadData& data, const ClockType::time_point now);
+
+  //! the body of the metrics thread
+  void runMetrics();
+
+  //! writes a snapshot to the metrics file and makes it the reference of the next one
+  void writeMetricsFile();
+
+  //! joins the metrics thread and closes the socket, neither queries MPI nor writes a snapshot
+  void stopMetrics();
+
 public:
+  /** \return the handle for section_name, registering it if necessary
+   *  the handle stays valid for the lifetime of the profiler (in particular across reset() and nextRun())
+   **/
+  SectionHandle registerSection(const std::string section_name);
+
+  std::string sectionName(const SectionHandle section) const;
+
+  //! begin timing a registered section on this thread, does nothing if it is already running
+  void startTiming(const SectionHandle section);
+
+  //! stop timing a registered section on this thread, \return the milliseconds since the corresponding start
+  long stopTiming(const SectionHandle section);
+
   //! set this to begin a named section
   void startTiming(const std::string section_name);
 
   //! stop named section's counter
-  long stopTiming(const std::string section_name, const bool use_walltime = false);
+  long stopTiming(const std::string section_name);
+
+  //! the wall time is the only clock sampled, so use_walltime has no effect
+  long DUNE_DEPRECATED_MSG("use_walltime has no effect, use stopTiming(section_name) instead")
+  stopTiming(const std::string section_name, const bool use_walltime);
 
   //! set elapsed time back to 0 for section_name
   void resetTiming(const std::string section_name);
 
-  //! get runtime of section in current run in milliseconds
+  /** get runtime of section in current run in milliseconds
+   *  averaged over the threads that timed it, or the maximum over these threads if use_walltime is true
+   **/
   long getTiming(const std::string section_name, const bool use_walltime = false) const;
 
   /** output to currently pre-defined (csv) file, does not output individual run results, but average over all recorded
    * results
+   * For each section, the minimum, median, 95th percentile, maximum and standard deviation over the runs are appended,
+   * as well as the number of outliers (runs further than three scaled median absolute deviations from the median).
+   * Warm-up runs (see setWarmupRuns()) are excluded.
      **/
   void outputAveraged(const int refineLevel,
                       const long numDofs,
@@ -118,8 +316,94 @@ public:
   //! file-output the named sections only
   void outputTimings(const std::string filename) const;
   void outputTimings(std::ostream& out = std::cout) const;
+  /** the timings of all runs, a line per run
+   *  For each section the columns _avg_per_thread and _max_per_thread hold the wall time averaged over the threads
+   *  that timed it, _avg_wall and _max_wall the maximum over these threads, each averaged resp. maximized over the
+   *  ranks.
+   **/
   void outputTimingsAll(std::ostream& out = std::cout) const;
 
+  /** the call tree of all sections (merged over all threads by their paths from the root and over all runs since the
+   *  last reset()) in collapsed stack format, as expected by flamegraph.pl: a line "outer;inner <self time>" per
+   *  section path, the exclusive time is given in microseconds
+   **/
+  void outputCallTreeCollapsed(std::ostream& out = std::cout) const;
+
+  //! the call tree as JSON, with name, calls, inclusive_ms, exclusive_ms and children for each node
+  void outputCallTreeJson(std::ostream& out = std::cout) const;
+
+  //! writes filename.folded and filename.json to the output directory
+  void outputCallTree(const std::string filename) const;
+
+  /** \brief records the begin and end of each section call for a timeline of all threads
+   *
+   *  The events are stored in per-thread buffers of capacity events each, which are allocated on the first event of
+   *  the respective thread, further events are dropped. disableTracing() writes the events as Chrome trace
+   *  (to be opened with Perfetto or chrome://tracing) to filename in the output directory, prefixed by the rank if
+   *  there is more than one. Thread ids are given by ThreadManager::thread(). Nothing is written for an empty filename.
+   **/
+  void enableTracing(const std::string filename = "trace.json", const std::size_t capacity = 1 << 20);
+
+  /** stops recording events and writes all events recorded so far to the file given to enableTracing()
+   *  Has to be called while MPI is still initialized and no thread is timing a section.
+   **/
+  void disableTracing();
+
+  //! all recorded events in Chrome trace event format
+  void outputTrace(std::ostream& out) const;
+
+  /** \brief counts cycles, instructions, cache references and misses as well as branches and branch misses per section
+   *
+   *  The counters are opened via perf_event_open on each thread when it first times a section (linux only), threads
+   *  without permission simply do not contribute. Reading the counters costs a system call per start and stop.
+   *  outputTimings() and outputAveraged() then additionally list the instructions per cycle, the cache miss rate and
+   *  the branch miss rate of each section.
+   *  \return whether the counters are available on the calling thread
+   **/
+  bool enableCounters();
+
+  void disableCounters();
+
+  /** \brief counts the allocations (calls of operator new) and allocated bytes per section
+   *
+   *  Allocations are attributed to the innermost section running on the allocating thread, allocations outside of any
+   *  section are not counted. Additionally the peak resident set size of the process is sampled at the end of each
+   *  section call (unix only). outputTimings() then additionally lists these for each section.
+   *  Counting requires dune-stuff to be compiled with DUNE_STUFF_PROFILE_ALLOCATIONS, which replaces the global
+   *  operator new and delete, it then costs a check of a flag per allocation while disabled.
+   *  \return whether allocations can be counted
+   **/
+  bool enableAllocationTracking();
+
+  void disableAllocationTracking();
+
+  enum class MetricsFormat { json, prometheus };
+
+  /** \brief publishes the cumulative time and calls of each section, the counts of addCount() and the utilization of
+   *         each thread while the program is running
+   *
+   *  If target starts with "unix:", a background thread writes the current metrics to each client connecting to the
+   *  UNIX domain socket at the remaining path (unix only). Otherwise the metrics are written to the file target in the
+   *  output directory every interval, the file is replaced atomically so readers never see a partial snapshot. With
+   *  more than one MPI process the rank is added to the socket path and file name.
+   *  Each thread publishes its totals when it stops a section and its last publication is older than interval, so the
+   *  metrics may lag behind by an interval (or more for threads that do not stop any sections). The utilization of a
+   *  thread is the fraction of the time since the previous snapshot it spent in outermost sections.
+   **/
+  void enableMetrics(const std::string target = "metrics.prom",
+                     const MetricsFormat format = MetricsFormat::prometheus,
+                     const std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+  /** stops the metrics thread, a metrics file is written one last time by the calling thread
+   *  The destructor only stops the thread, call this before MPI_Finalize() to get the final snapshot.
+   **/
+  void disableMetrics();
+
+  /** the published metrics in Prometheus text or JSON format
+   *  The utilization refers to the last snapshot of the metrics thread (or enableMetrics()), which is not affected.
+   **/
+  void outputMetrics(std::ostream& out, const MetricsFormat format = MetricsFormat::prometheus) const;
+
   /** call this with correct numRuns <b> before </b> starting any profiling
      *  if you're planning on doing more than one iteration of your code
      *  called once fromm ctor with numRuns=1
@@ -135,7 +419,19 @@ public:
 
   void setOutputdir(const std::string dir);
 
+  //! the first runs runs are not taken into account by outputAveraged()
+  void setWarmupRuns(const size_t runs);
+
 private:
+  /** the metrics in format, with the utilization since the reference snapshot
+   *  \return the busy time of each thread at now, to be passed to advanceMetricsBaseline()
+   **/
+  std::map< std::size_t, ClockType::duration > writeMetrics(std::ostream& out, const MetricsFormat format,
+                                                            const ClockType::time_point now, const int rank) const;
+
+  //! the utilization of the next snapshot refers to busy at now
+  void advanceMetricsBaseline(const ClockType::time_point now, std::map< std::size_t, ClockType::duration > busy);
+
   DatamapVector datamaps_;
   size_t current_run_number_;
   //! runtime tables etc go there
@@ -143,9 +439,34 @@ private:
   // debug counter, only outputted in debug mode
   std::map< size_t, size_t > counters_;
 
-  KnownTimersMap known_timers_map_;
+  std::map< std::string, SectionHandle > section_handles_;
+  std::vector< std::string > section_names_;
+  PerThreadValue< ThreadData > thread_data_;
   const std::string csv_sep_;
-  std::mutex mutex_;
+  size_t warmup_runs_;
+  mutable std::mutex mutex_;
+  std::atomic< bool > tracing_;
+  std::atomic< bool > counting_;
+  std::vector< CounterMap > counter_maps_;
+  std::vector< AllocationMap > allocation_maps_;
+  std::atomic< std::size_t > trace_capacity_;
+  std::string trace_filename_;
+  ClockType::time_point trace_begin_;
+  std::atomic< bool > publishing_;
+  ClockType::duration metrics_interval_;
+  MetricsFormat metrics_format_;
+  std::string metrics_target_;
+  //! queried by enableMetrics(), MPI may only be called from the main thread
+  int metrics_rank_;
+  int metrics_socket_;
+  std::vector< std::shared_ptr< MetricsSnapshot > > metrics_snapshots_;
+  std::thread metrics_thread_;
+  std::atomic< bool > metrics_stop_;
+  mutable std::mutex metrics_mutex_;
+  std::condition_variable metrics_condition_;
+  //! state of the previous snapshot of the metrics thread for the utilization, guarded by metrics_mutex_
+  ClockType::time_point metrics_previous_time_;
+  std::map< std::size_t, ClockType::duration > metrics_previous_busy_;
 
   static Profiler& instance() {
     static Profiler pf;
@@ -162,21 +483,27 @@ inline Profiler& profiler() {
 class ScopedTiming : public boost::noncopyable
 {
 protected:
-  const std::string section_name_;
+  const Profiler::SectionHandle section_;
 
 public:
   inline ScopedTiming(const std::string& section_name)
-    : section_name_(section_name) {
-    profiler().startTiming(section_name_);
+    : section_(profiler().registerSection(section_name)) {
+    profiler().startTiming(section_);
+  }
+
+  inline ScopedTiming(const Profiler::SectionHandle section)
+    : section_(section) {
+    profiler().startTiming(section_);
   }
 
   inline ~ScopedTiming() {
-    profiler().stopTiming(section_name_);
+    profiler().stopTiming(section_);
   }
 };
 
 struct OutputScopedTiming : public ScopedTiming {
   OutputScopedTiming(const std::string& section_name, std::ostream& out);
+  OutputScopedTiming(const Profiler::SectionHandle section, std::ostream& out);
 
   ~OutputScopedTiming();
 protected:
@@ -191,9 +518,13 @@ protected:
 #define DSC_PROFILER Dune::Stuff::Common::profiler()
 
 
+/** times the enclosing scope, the section is registered on the first pass only
+ *  \note section_name has to evaluate to the same name on every pass (per template instantiation)
+ **/
 #if DUNE_STUFF_DO_PROFILE
 # define DUNE_STUFF_PROFILE_SCOPE(section_name) \
-    Dune::Stuff::Common::ScopedTiming DUNE_UNUSED(timer)(section_name)
+    static const auto dune_stuff_profile_section = DSC_PROFILER.registerSection(section_name); \
+    Dune::Stuff::Common::ScopedTiming DUNE_UNUSED(timer)(dune_stuff_profile_section)
 #else
 # define DUNE_STUFF_PROFILE_SCOPE(section_name)
 #endif
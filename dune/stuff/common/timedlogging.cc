@@ -17,6 +17,20 @@
 namespace Dune {
 namespace Stuff {
 namespace Common {
+namespace {
+
+
+//! disabled output goes to dev_null directly, there is no need to prefix it
+std::shared_ptr< std::ostream > make_stream(const Timer& timer, const std::string prefix, std::ostream& out)
+{
+  if (&out == &dev_null)
+    return std::shared_ptr< std::ostream >(&dev_null, [](std::ostream*) {});
+  return std::make_shared< TimedPrefixedLogStream >(timer, prefix, out);
+}
+
+
+} // namespace
+
 
 TimedLogManager::TimedLogManager(const Timer& timer,
                                  const std::string info_prefix,
@@ -31,19 +45,17 @@ TimedLogManager::TimedLogManager(const Timer& timer,
                                  std::ostream& warn_out)
   : timer_(timer)
   , current_level_(current_level)
-  , info_(std::make_shared< TimedPrefixedLogStream >(timer_,
-                                                     info_prefix,
-                                                     current_level_ <= max_info_level ? enabled_out : disabled_out))
-  , debug_(std::make_shared< TimedPrefixedLogStream >(timer_,
-                                                      debug_prefix,
+  , level_(current_level_)
+  , info_enabled_(level_ <= max_info_level)
+  , debug_enabled_(level_ <= max_debug_level)
+  , warn_enabled_(enable_warnings)
+  , info_(make_stream(timer_, info_prefix, info_enabled_ ? enabled_out : disabled_out))
 #ifdef NDEBUG
-                                                      current_level_ <= max_debug_level ? enabled_out : dev_null))
+  , debug_(make_stream(timer_, debug_prefix, debug_enabled_ ? enabled_out : dev_null))
 #else
-                                                      current_level_ <= max_debug_level ? enabled_out : disabled_out))
+  , debug_(make_stream(timer_, debug_prefix, debug_enabled_ ? enabled_out : disabled_out))
 #endif
-  , warn_(std::make_shared< TimedPrefixedLogStream >(timer_,
-                                                     warning_prefix,
-                                                     enable_warnings ? warn_out : disabled_out))
+  , warn_(make_stream(timer_, warning_prefix, warn_enabled_ ? warn_out : disabled_out))
 {}
 
 TimedLogManager::~TimedLogManager()
@@ -14,6 +14,7 @@
 #include <string>
 #include <mutex>
 #include <atomic>
+#include <limits>
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
@@ -24,6 +25,23 @@
 #include <dune/stuff/common/logstreams.hh>
 #include <dune/stuff/common/color.hh>
 
+/**
+ * \brief Compile-time maximum levels of TimedLogManager, see DSC_TIMED_LOG_INFO and DSC_TIMED_LOG_DEBUG.
+ *
+ *        Logging with these macros above the respective level is removed completely by the compiler. Defaults to no
+ *        restriction for info and to no debug logging at all if NDEBUG is defined.
+ */
+#ifndef DUNE_STUFF_TIMEDLOGGING_MAX_INFO_LEVEL
+# define DUNE_STUFF_TIMEDLOGGING_MAX_INFO_LEVEL std::numeric_limits< ssize_t >::max()
+#endif
+#ifndef DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL
+# ifdef NDEBUG
+#   define DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL -1
+# else
+#   define DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL std::numeric_limits< ssize_t >::max()
+# endif
+#endif
+
 namespace Dune {
 namespace Stuff {
 namespace Common {
@@ -56,9 +74,41 @@ public:
 
   std::ostream& warn();
 
+  /**
+   * \name Checks whether output to the respective stream is shown.
+   * \note Prefer the macros DSC_TIMED_LOG_INFO, DSC_TIMED_LOG_DEBUG and DSC_TIMED_LOG_WARN, which do not evaluate
+   *       their output if it would not be shown.
+   * \{
+   */
+  bool info_enabled() const
+  {
+    return DUNE_STUFF_TIMEDLOGGING_MAX_INFO_LEVEL >= 0
+        && level_ <= ssize_t(DUNE_STUFF_TIMEDLOGGING_MAX_INFO_LEVEL)
+        && info_enabled_;
+  }
+
+  bool debug_enabled() const
+  {
+    return DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL >= 0
+        && level_ <= ssize_t(DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL)
+        && debug_enabled_;
+  }
+
+  bool warn_enabled() const
+  {
+    return warn_enabled_;
+  }
+  /**
+   * \}
+   */
+
 private:
   const Timer& timer_;
   std::atomic< ssize_t >& current_level_;
+  const ssize_t level_;
+  const bool info_enabled_;
+  const bool debug_enabled_;
+  const bool warn_enabled_;
   std::shared_ptr< std::ostream > info_;
   std::shared_ptr< std::ostream > debug_;
   std::shared_ptr< std::ostream > warn_;
@@ -204,8 +254,9 @@ int main()
   logger.warn() << "<- The 'warn' prefix left of this should be red!"   << std::endl;
 }
 \endcode
- * \note Debug logging is only enabled if NDEBUG is not defined but you might still want to guard calls to
- *       logger.debug() for performance reasons.
+ * \note Output to disabled streams is still evaluated, use the DSC_TIMED_LOG_INFO, DSC_TIMED_LOG_DEBUG and
+ *       DSC_TIMED_LOG_WARN macros in performance critical code. If NDEBUG is defined, the DSC_TIMED_LOG_DEBUG macro does
+ *       not produce any code by default (see DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL).
  */
 TimedLogging& TimedLogger();
 
@@ -214,5 +265,25 @@ TimedLogging& TimedLogger();
 } // namespace Stuff
 } // namespace Dune
 
+/**
+ * \name Logging to a TimedLogManager without any cost if the output would not be shown.
+ *
+ *        The output is only evaluated if it is shown, e.g.
+\code
+auto logger = TimedLogger().get("user_function");
+DSC_TIMED_LOG_DEBUG(logger) << "the expensive " << vector << " is only printed if debug output is enabled" << std::endl;
+\endcode
+ *        In addition, logging above DUNE_STUFF_TIMEDLOGGING_MAX_INFO_LEVEL and DUNE_STUFF_TIMEDLOGGING_MAX_DEBUG_LEVEL is
+ *        removed at compile time.
+ * \note  The macros evaluate logger more than once, so pass a named TimedLogManager and not TimedLogger().get(...).
+ * \{
+ */
+#define DSC_TIMED_LOG_INFO(logger)  if (!(logger).info_enabled())  {} else (logger).info()
+#define DSC_TIMED_LOG_DEBUG(logger) if (!(logger).debug_enabled()) {} else (logger).debug()
+#define DSC_TIMED_LOG_WARN(logger)  if (!(logger).warn_enabled())  {} else (logger).warn()
+/**
+ * \}
+ */
+
 
 #endif // DUNE_STUFF_COMMON_TIMED_LOGGING_HH
@@ -11,13 +11,18 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <bitset>
 #include <type_traits>
 #include <functional>
+#include <chrono>
+#include <typeinfo>
 
 #include <dune/common/version.hh>
 
 #if DUNE_VERSION_NEWER(DUNE_COMMON,3,9) //EXADUNE
 # include <dune/grid/utility/partitioning/ranged.hh>
+# include <dune/grid/utility/partitioning/seedlist.hh>
 # include <dune/stuff/common/parallel/threadmanager.hh>
 #endif
 
@@ -29,9 +34,11 @@
 
 #include <dune/stuff/grid/entity.hh>
 #include <dune/stuff/grid/intersection.hh>
+#include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/configuration.hh>
 #include <dune/stuff/common/ranges.hh>
 #include <dune/stuff/common/parallel/threadmanager.hh>
-#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/parallel/partitioner.hh>
 
 #include "walker/functors.hh"
 #include "walker/apply-on.hh"
@@ -54,6 +61,7 @@ public:
 
   explicit Walker(GridViewType grd_vw)
     : grid_view_(grd_vw)
+    , use_load_balancing_(false)
   {}
 
   const GridViewType& grid_view() const
@@ -61,6 +69,28 @@ public:
     return grid_view_;
   }
 
+  /**
+   * \brief Balances subsequent parallel walks (walk(true)) by the measured cost of the entities.
+   *
+   *        The entities are partitioned along a space filling curve (see SpaceFillingCurvePartitioner). Each walk
+   *        measures the wall time spent on each partition, attributes it evenly to the entities of the partition
+   *        (see entity_weights()) and the curve is re-cut accordingly for the next walk, so that the partitions take
+   *        about the same time. The partitioning is rebuilt if the number of entities changes, call
+   *        use_load_balancing() again to force this.
+   */
+  void use_load_balancing(const bool use = true)
+  {
+    use_load_balancing_ = use;
+    balancing_partitioner_.reset();
+    entity_weights_.clear();
+  }
+
+  //! measured cost (in seconds) per entity index of the last balanced walk, empty if there was none
+  const std::vector< double >& entity_weights() const
+  {
+    return entity_weights_;
+  }
+
   void add(std::function< void(const EntityType&) > lambda,
            const ApplyOn::WhichEntity< GridViewType >* where = new ApplyOn::AllEntities< GridViewType >())
   {
@@ -137,6 +167,10 @@ public:
   {
     codim0_functors_.clear();
     codim1_functors_.clear();
+    codim0_filters_.clear();
+    codim1_filters_.clear();
+    codim0_filter_of_functor_.clear();
+    codim1_filter_of_functor_.clear();
   } // ... clear()
 
   virtual void prepare()
@@ -145,6 +179,7 @@ public:
       functor->prepare();
     for (auto& functor : codim1_functors_)
       functor->prepare();
+    group_filters();
   } // ... prepare()
 
   bool apply_on(const EntityType& entity) const
@@ -165,18 +200,46 @@ public:
 
   virtual void apply_local(const EntityType& entity)
   {
-    for (auto& functor : codim0_functors_)
-      if (functor->apply_on(grid_view_, entity))
+    // functors added after prepare()
+    if (codim0_filter_of_functor_.size() != codim0_functors_.size()) {
+      for (auto& functor : codim0_functors_)
+        if (functor->apply_on(grid_view_, entity))
+          functor->apply_local(entity);
+      return;
+    }
+    // evaluate each distinct filter once
+    std::bitset< max_filters > applies;
+    for (size_t ff = 0; ff < codim0_filters_.size(); ++ff)
+      applies[ff] = codim0_filters_[ff]->apply_on(grid_view_, entity);
+    for (size_t ii = 0; ii < codim0_functors_.size(); ++ii) {
+      auto& functor = codim0_functors_[ii];
+      const auto ff = codim0_filter_of_functor_[ii];
+      if (ff < max_filters ? applies.test(ff) : functor->apply_on(grid_view_, entity))
         functor->apply_local(entity);
+    }
   } // ... apply_local(...)
 
   virtual void apply_local(const IntersectionType& intersection,
                            const EntityType& inside_entity,
                            const EntityType& outside_entity)
   {
-    for (auto& functor : codim1_functors_)
-      if (functor->apply_on(grid_view_, intersection))
+    // functors added after prepare()
+    if (codim1_filter_of_functor_.size() != codim1_functors_.size()) {
+      for (auto& functor : codim1_functors_)
+        if (functor->apply_on(grid_view_, intersection))
+          functor->apply_local(intersection, inside_entity, outside_entity);
+      return;
+    }
+    // evaluate each distinct filter once
+    std::bitset< max_filters > applies;
+    for (size_t ff = 0; ff < codim1_filters_.size(); ++ff)
+      applies[ff] = codim1_filters_[ff]->apply_on(grid_view_, intersection);
+    for (size_t ii = 0; ii < codim1_functors_.size(); ++ii) {
+      auto& functor = codim1_functors_[ii];
+      const auto ff = codim1_filter_of_functor_[ii];
+      if (ff < max_filters ? applies.test(ff) : functor->apply_on(grid_view_, intersection))
         functor->apply_local(intersection, inside_entity, outside_entity);
+    }
   } // ... apply_local(...)
 
   virtual void finalize()
@@ -193,6 +256,10 @@ public:
     if (use_tbb) {
       const auto num_partitions = DSC_CONFIG_GET("threading.partition_factor", 1u)
                                   * threadManager().current_threads();
+      if (use_load_balancing_) {
+        walk_balanced(num_partitions);
+        return;
+      }
       RangedPartitioning< GridViewType, 0 > partitioning(grid_view_, num_partitions);
       this->walk(partitioning);
       return;
@@ -216,57 +283,225 @@ public:
 #if HAVE_TBB
 
 protected:
+  /**
+   *  Each body walks its partitions with its own copy of the walker (see worker_copy()), in which every
+   *  Functor::Codim0And1 that supports clone() is replaced by a clone (all other functors are shared). Since
+   *  tbb::parallel_deterministic_reduce splits and joins the bodies in an order that only depends on the range and the
+   *  grain size, the partial results are merged reproducibly, for any number of threads. Without a copy the body walks
+   *  with the original walker.
+   */
   template< class PartioningType, class WalkerType >
   struct Body
   {
-    Body(WalkerType& walker, PartioningType& partitioning)
+    Body(WalkerType& walker, PartioningType& partitioning, std::vector< double >* partition_times)
       : walker_(walker)
       , partitioning_(partitioning)
+      , partition_times_(partition_times)
+      , worker_walker_(walker_.worker_copy(clones_))
     {}
 
     Body(Body& other, tbb::split /*split*/)
       : walker_(other.walker_)
       , partitioning_(other.partitioning_)
+      , partition_times_(other.partition_times_)
+      , worker_walker_(walker_.worker_copy(clones_))
     {}
 
-    void operator()(const tbb::blocked_range< std::size_t > &range) const
+    void operator()(const tbb::blocked_range< std::size_t > &range)
     {
       // for all partitions in tbb-range
       for(std::size_t p = range.begin(); p != range.end(); ++p) {
+        typedef std::chrono::steady_clock ClockType;
+        const auto start = partition_times_ ? ClockType::now() : ClockType::time_point();
         auto partition = partitioning_.partition(p);
-        walker_.walk_range(partition);
+        // keep using the original walker if nothing was cloned, derived walkers might have overridden apply_local()
+        if (!worker_walker_ || clones_.empty())
+          walker_.walk_range(partition);
+        else
+          worker_walker_->walk_range(partition);
+        // each partition is walked by exactly one body
+        if (partition_times_)
+          (*partition_times_)[p] = std::chrono::duration< double >(ClockType::now() - start).count();
       }
     }
 
-    void join(Body& /*other*/)
-    {}
+    void join(Body& other)
+    {
+      clones_.join(other.clones_);
+    }
 
     WalkerType& walker_;
     const PartioningType& partitioning_;
+    std::vector< double >* partition_times_;
+    internal::Codim0And1Clones< GridViewType > clones_;
+    std::unique_ptr< WalkerType > worker_walker_;
   }; // struct Body
 
 public:
+  /**
+   * \brief Walks the grid in parallel, one partition at a time.
+   *
+   *        The partitions are grouped into chunks of threading.partition_grainsize (defaults to 1) partitions, which
+   *        are distributed among the threads by work stealing. The chunks do not depend on the number of threads, so
+   *        functors joining their clones get bit-identical results for a given partitioning. See Functor::Codim0And1::clone() on how to avoid shared state in the functors.
+   */
   template< class PartioningType >
   void walk(PartioningType& partitioning)
   {
     // prepare functors
     prepare();
 
+    // only do something, if we have to
+    if ((codim0_functors_.size() + codim1_functors_.size()) > 0)
+      walk_partitions(partitioning, 0, partitioning.partitions());
+
+    // finalize functors
+    finalize();
+    clear();
+  } // ... tbb_walk(...)
+
+  /**
+   * \brief Walks the grid in parallel, one color of partitions after the other.
+   *
+   *        All partitions of one color are walked in parallel as in walk(partitioning), the colors are processed
+   *        sequentially. Given a ColoredPartitioner, partitions of the same color do not share any data (see there),
+   *        so functors may scatter into global containers without locking.
+   * \note  The partitions of color c are expected to be numbered [coloring.color_begin(c), coloring.color_end(c)).
+   */
+  template< class PartioningType, class ColoringType >
+  void walk(PartioningType& partitioning, const ColoringType& coloring)
+  {
+    // prepare functors
+    prepare();
+
     // only do something, if we have to
     if ((codim0_functors_.size() + codim1_functors_.size()) > 0) {
-      tbb::blocked_range< std::size_t > range(0, partitioning.partitions());
-      Body< PartioningType, ThisType > body(*this, partitioning);
-      tbb::parallel_reduce(range, body);
+      for (std::size_t color = 0; color < coloring.colors(); ++color)
+        walk_partitions(partitioning, coloring.color_begin(color), coloring.color_end(color));
     }
 
     // finalize functors
     finalize();
     clear();
-  } // ... tbb_walk(...)
+  } // ... walk(...)
+
+protected:
+  //! \param partition_times if given, the wall time spent on partition p is stored in (*partition_times)[p]
+  template< class PartioningType >
+  void walk_partitions(PartioningType& partitioning, const std::size_t begin, const std::size_t end,
+                       std::vector< double >* partition_times = nullptr)
+  {
+    if (end <= begin)
+      return;
+    // a default depending on the number of threads would change the order of the joins with it
+    const std::size_t grainsize = DSC_CONFIG_GET("threading.partition_grainsize", std::size_t(1));
+    tbb::blocked_range< std::size_t > range(begin, end, std::max(std::size_t(1), grainsize));
+    Body< PartioningType, ThisType > body(*this, partitioning, partition_times);
+    tbb::parallel_deterministic_reduce(range, body);
+    body.clones_.join_into_originals();
+  } // ... walk_partitions(...)
+
+#if DUNE_VERSION_NEWER(DUNE_COMMON,3,9) //EXADUNE
+  void walk_balanced(const std::size_t num_partitions)
+  {
+    const std::size_t num_entities = grid_view_.size(0);
+    if (!balancing_partitioner_
+        || entity_weights_.size() != num_entities
+        || balancing_partitioner_->partitions() != std::min(num_partitions, num_entities)) {
+      balancing_partitioner_ = Common::make_unique< SpaceFillingCurvePartitioner< GridViewType > >(grid_view_,
+                                                                                                   num_partitions);
+      entity_weights_.clear();
+    } else
+      balancing_partitioner_->cut(entity_weights_);
+    SeedListPartitioning< typename GridViewType::Grid, 0 > partitioning(grid_view_, *balancing_partitioner_);
+
+    // prepare functors
+    prepare();
+
+    // only do something, if we have to
+    if ((codim0_functors_.size() + codim1_functors_.size()) > 0) {
+      const auto partitions = balancing_partitioner_->partitions();
+      std::vector< double > partition_times(partitions, 0.);
+      walk_partitions(partitioning, 0, partitions, &partition_times);
+      // spread the time of each partition evenly onto its entities
+      std::vector< std::size_t > partition_sizes(partitions, 0);
+      for (std::size_t ii = 0; ii < num_entities; ++ii)
+        ++partition_sizes[balancing_partitioner_->partition_of_index(ii)];
+      entity_weights_.resize(num_entities);
+      for (std::size_t ii = 0; ii < num_entities; ++ii) {
+        const auto pp = balancing_partitioner_->partition_of_index(ii);
+        entity_weights_[ii] = partition_times[pp] / double(partition_sizes[pp]);
+      }
+    } // only do something, if we have to
+
+    // finalize functors
+    finalize();
+    clear();
+  } // ... walk_balanced(...)
+#endif // DUNE_VERSION_NEWER(DUNE_COMMON,3,9)
+
+public:
 
 #endif // HAVE_TBB
 
 protected:
+  /**
+   * \brief A walker on the same grid view, to be used by a single worker of walk(partitioning).
+   *
+   *        A plain Walker would bypass the apply_local() of a derived walker, so for derived walkers nullptr is
+   *        returned and all workers share this walker and all of its functors (clone() is not used). Derived walkers
+   *        that want clones have to override this, create a copy of their own type and fill it via copy_functors_to().
+   */
+  virtual std::unique_ptr< ThisType > worker_copy(internal::Codim0And1Clones< GridViewType >& clones)
+  {
+    if (typeid(*this) != typeid(ThisType))
+      return nullptr;
+    auto copy = Common::make_unique< ThisType >(grid_view_);
+    copy_functors_to(*copy, clones);
+    return copy;
+  } // ... worker_copy(...)
+
+  //! adds the worker copies of all functors (clones where available) to copy
+  void copy_functors_to(ThisType& copy, internal::Codim0And1Clones< GridViewType >& clones)
+  {
+    for (auto& functor : codim0_functors_)
+      copy.codim0_functors_.emplace_back(functor->worker_copy(clones));
+    for (auto& functor : codim1_functors_)
+      copy.codim1_functors_.emplace_back(functor->worker_copy(clones));
+    copy.group_filters();
+  } // ... copy_functors_to(...)
+
+  /**
+   *  Groups the functors by equivalent filters (see ApplyOn::WhichEntity::equivalent()), so that apply_local() only
+   *  has to evaluate each distinct filter once. Functors with more involved filters or exceeding max_filters distinct
+   *  filters are marked with max_filters and evaluated individually.
+   */
+  void group_filters()
+  {
+    codim0_filters_.clear();
+    codim1_filters_.clear();
+    codim0_filter_of_functor_.clear();
+    codim1_filter_of_functor_.clear();
+    for (const auto& functor : codim0_functors_)
+      codim0_filter_of_functor_.push_back(find_or_add_filter(functor->filter(), codim0_filters_));
+    for (const auto& functor : codim1_functors_)
+      codim1_filter_of_functor_.push_back(find_or_add_filter(functor->filter(), codim1_filters_));
+  } // ... group_filters(...)
+
+  template< class FilterType >
+  static size_t find_or_add_filter(const FilterType* filter, std::vector< const FilterType* >& filters)
+  {
+    if (!filter)
+      return max_filters;
+    for (size_t ff = 0; ff < filters.size(); ++ff)
+      if (filters[ff]->equivalent(*filter))
+        return ff;
+    if (filters.size() == max_filters)
+      return max_filters;
+    filters.push_back(filter);
+    return filters.size() - 1;
+  } // ... find_or_add_filter(...)
+
   template< class EntityRange >
   void walk_range(const EntityRange& entity_range)
   {
@@ -303,8 +538,16 @@ protected:
   } // ... walk_range(...)
 
   const GridViewType grid_view_;
+  bool use_load_balancing_;
+  std::unique_ptr< SpaceFillingCurvePartitioner< GridViewType > > balancing_partitioner_;
+  std::vector< double > entity_weights_;
   std::vector< std::unique_ptr< internal::Codim0Object<GridViewType> > > codim0_functors_;
   std::vector< std::unique_ptr< internal::Codim1Object<GridViewType> > > codim1_functors_;
+  static const size_t max_filters = 64;
+  std::vector< const ApplyOn::WhichEntity< GridViewType >* > codim0_filters_;
+  std::vector< const ApplyOn::WhichIntersection< GridViewType >* > codim1_filters_;
+  std::vector< size_t > codim0_filter_of_functor_;
+  std::vector< size_t > codim1_filter_of_functor_;
 }; // class Walker
 
 } // namespace Grid
@@ -40,6 +40,17 @@ public:
   virtual ~WhichEntity() {}
 
   virtual bool apply_on(const GridViewType& /*grid_view*/, const EntityType& /*entity*/) const = 0;
+
+  /**
+   * \brief Tells if other selects the same entities as this.
+   *
+   *        Walker evaluates equivalent filters only once per entity. By default a filter is only equivalent to itself,
+   *        stateless filters are equivalent to all filters of the same type.
+   */
+  virtual bool equivalent(const WhichEntity< GridViewImp >& other) const
+  {
+    return this == &other;
+  }
 }; // class WhichEntity
 
 
@@ -59,6 +70,11 @@ public:
   {
     return true;
   }
+
+  virtual bool equivalent(const WhichEntity< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const AllEntities< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class AllEntities
 
 
@@ -78,6 +94,11 @@ public:
   {
     return entity.hasBoundaryIntersections();
   }
+
+  virtual bool equivalent(const WhichEntity< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const BoundaryEntities< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class BoundaryEntities
 
 
@@ -102,6 +123,17 @@ public:
   virtual ~WhichIntersection< GridViewImp >() {}
 
   virtual bool apply_on(const GridViewType& /*grid_view*/, const IntersectionType& /*intersection*/) const = 0;
+
+  /**
+   * \brief Tells if other selects the same intersections as this.
+   *
+   *        Walker evaluates equivalent filters only once per intersection. By default a filter is only equivalent to
+   *        itself, stateless filters are equivalent to all filters of the same type.
+   */
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const
+  {
+    return this == &other;
+  }
 }; // class WhichIntersection< GridViewImp >
 
 
@@ -123,6 +155,11 @@ public:
   {
     return true;
   }
+
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const AllIntersections< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class AllIntersections
 
 
@@ -149,6 +186,11 @@ public:
   {
     return intersection.neighbor() && !intersection.boundary();
   }
+
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const InnerIntersections< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class InnerIntersections
 
 
@@ -182,6 +224,11 @@ public:
     } else
       return false;
   }
+
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const InnerIntersectionsPrimally< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class InnerIntersections
 
 
@@ -199,6 +246,11 @@ public:
   {
     return intersection.boundary();
   }
+
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const BoundaryIntersections< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class BoundaryIntersections
 
 
@@ -216,6 +268,11 @@ public:
   {
     return intersection.boundary() && !intersection.neighbor();
   }
+
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const NonPeriodicBoundaryIntersections< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class BoundaryIntersections
 
 
@@ -242,6 +299,11 @@ public:
   {
     return intersection.neighbor() && intersection.boundary();
   }
+
+  virtual bool equivalent(const WhichIntersection< GridViewImp >& other) const override final
+  {
+    return dynamic_cast< const PeriodicIntersections< GridViewImp >* >(&other) != nullptr;
+  }
 }; // class PeriodicIntersections
 
 
@@ -9,6 +9,8 @@
 //nothing here will compile w/o grid present
 #if HAVE_DUNE_GRID
 
+#include <memory>
+
 #include <dune/stuff/grid/entity.hh>
 #include <dune/stuff/grid/intersection.hh>
 #include <dune/stuff/grid/boundaryinfo.hh>
@@ -75,6 +77,27 @@ public:
                            const EntityType& /*outside_entity*/) = 0;
 
   virtual void finalize() {}
+
+  /**
+   * \brief Creates a copy of this functor to be used exclusively by one worker of a parallel Walker::walk().
+   *
+   *        The copy is created after prepare() has been called on this functor and is expected to start with empty
+   *        partial results. Return nullptr (the default) if the functor is thread safe and shall be shared among all
+   *        workers.
+   */
+  virtual std::unique_ptr< Codim0And1< GridViewImp > > clone() const
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Merges the partial results of other (obtained by clone()) into this functor.
+   *
+   *        The walker calls join() in a fixed order (given by the partitioning), so the results of a parallel walk are
+   *        reproducible for a fixed number of threads. finalize() is only called on the original functor, after all
+   *        clones have been joined.
+   */
+  virtual void join(Codim0And1< GridViewImp >& /*other*/) {}
 }; // class Codim0And1
 
 
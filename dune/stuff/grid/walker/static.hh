@@ -0,0 +1,480 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_GRID_WALKER_STATIC_HH
+#define DUNE_STUFF_GRID_WALKER_STATIC_HH
+
+//nothing here will compile w/o grid present
+#if HAVE_DUNE_GRID
+
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include <dune/stuff/grid/entity.hh>
+#include <dune/stuff/grid/intersection.hh>
+#include <dune/stuff/common/ranges.hh>
+
+namespace Dune {
+namespace Stuff {
+namespace Grid {
+namespace internal {
+
+
+//! calls functor.prepare(), if present
+template< class FunctorType >
+auto static_prepare(FunctorType& functor, int) -> decltype(functor.prepare(), void())
+{
+  functor.prepare();
+}
+
+template< class FunctorType >
+void static_prepare(FunctorType& /*functor*/, long) {}
+
+//! calls functor.finalize(), if present
+template< class FunctorType >
+auto static_finalize(FunctorType& functor, int) -> decltype(functor.finalize(), void())
+{
+  functor.finalize();
+}
+
+template< class FunctorType >
+void static_finalize(FunctorType& /*functor*/, long) {}
+
+//! calls functor.apply_local(entity), if present, functor(entity) otherwise
+template< class FunctorType, class EntityType >
+auto static_apply(FunctorType& functor, const EntityType& entity, int) -> decltype(functor.apply_local(entity), void())
+{
+  functor.apply_local(entity);
+}
+
+template< class FunctorType, class EntityType >
+auto static_apply(FunctorType& functor, const EntityType& entity, long) -> decltype(functor(entity), void())
+{
+  functor(entity);
+}
+
+//! calls functor.apply_local(intersection, inside, outside), if present, functor(intersection, inside, outside) else
+template< class FunctorType, class IntersectionType, class EntityType >
+auto static_apply(FunctorType& functor,
+                  const IntersectionType& intersection,
+                  const EntityType& inside_entity,
+                  const EntityType& outside_entity,
+                  int) -> decltype(functor.apply_local(intersection, inside_entity, outside_entity), void())
+{
+  functor.apply_local(intersection, inside_entity, outside_entity);
+}
+
+template< class FunctorType, class IntersectionType, class EntityType >
+auto static_apply(FunctorType& functor,
+                  const IntersectionType& intersection,
+                  const EntityType& inside_entity,
+                  const EntityType& outside_entity,
+                  long) -> decltype(functor(intersection, inside_entity, outside_entity), void())
+{
+  functor(intersection, inside_entity, outside_entity);
+}
+
+
+//! default policy of the static walker, selects all entities and intersections
+struct StaticApplyOnAll
+{
+  template< class GridViewType, class EntityOrIntersectionType >
+  bool apply_on(const GridViewType& /*grid_view*/, const EntityOrIntersectionType& /*entity_or_intersection*/) const
+  {
+    return true;
+  }
+}; // struct StaticApplyOnAll
+
+
+/**
+ *  \brief Applies a functor to entities, see on_entities().
+ *
+ *  FunctorImp may be a reference type, in which case the functor is not copied.
+ */
+template< class FunctorImp, class WhichEntityImp >
+class StaticCodim0Entry
+{
+public:
+  static const bool codim1 = false;
+
+  StaticCodim0Entry(FunctorImp&& functor, const WhichEntityImp& where)
+    : functor_(std::forward< FunctorImp >(functor))
+    , where_(where)
+  {}
+
+  void prepare()
+  {
+    static_prepare(functor_, 0);
+  }
+
+  template< class GridViewType, class EntityType >
+  void apply_local(const GridViewType& grid_view, const EntityType& entity)
+  {
+    if (where_.apply_on(grid_view, entity))
+      static_apply(functor_, entity, 0);
+  }
+
+  template< class GridViewType, class IntersectionType, class EntityType >
+  void apply_local(const GridViewType& /*grid_view*/,
+                   const IntersectionType& /*intersection*/,
+                   const EntityType& /*inside_entity*/,
+                   const EntityType& /*outside_entity*/)
+  {}
+
+  void finalize()
+  {
+    static_finalize(functor_, 0);
+  }
+
+private:
+  FunctorImp functor_;
+  const WhichEntityImp where_;
+}; // class StaticCodim0Entry
+
+
+/**
+ *  \brief Applies a functor to intersections, see on_intersections().
+ *
+ *  FunctorImp may be a reference type, in which case the functor is not copied.
+ */
+template< class FunctorImp, class WhichIntersectionImp >
+class StaticCodim1Entry
+{
+public:
+  static const bool codim1 = true;
+
+  StaticCodim1Entry(FunctorImp&& functor, const WhichIntersectionImp& where)
+    : functor_(std::forward< FunctorImp >(functor))
+    , where_(where)
+  {}
+
+  void prepare()
+  {
+    static_prepare(functor_, 0);
+  }
+
+  template< class GridViewType, class EntityType >
+  void apply_local(const GridViewType& /*grid_view*/, const EntityType& /*entity*/)
+  {}
+
+  template< class GridViewType, class IntersectionType, class EntityType >
+  void apply_local(const GridViewType& grid_view,
+                   const IntersectionType& intersection,
+                   const EntityType& inside_entity,
+                   const EntityType& outside_entity)
+  {
+    if (where_.apply_on(grid_view, intersection))
+      static_apply(functor_, intersection, inside_entity, outside_entity, 0);
+  }
+
+  void finalize()
+  {
+    static_finalize(functor_, 0);
+  }
+
+private:
+  FunctorImp functor_;
+  const WhichIntersectionImp where_;
+}; // class StaticCodim1Entry
+
+
+/**
+ *  \brief Applies a functor to entities and intersections, see on_entities_and_intersections().
+ *
+ *  FunctorImp may be a reference type, in which case the functor is not copied.
+ */
+template< class FunctorImp, class WhichEntityImp, class WhichIntersectionImp >
+class StaticCodim0And1Entry
+{
+public:
+  static const bool codim1 = true;
+
+  StaticCodim0And1Entry(FunctorImp&& functor,
+                        const WhichEntityImp& which_entities,
+                        const WhichIntersectionImp& which_intersections)
+    : functor_(std::forward< FunctorImp >(functor))
+    , which_entities_(which_entities)
+    , which_intersections_(which_intersections)
+  {}
+
+  void prepare()
+  {
+    static_prepare(functor_, 0);
+  }
+
+  template< class GridViewType, class EntityType >
+  void apply_local(const GridViewType& grid_view, const EntityType& entity)
+  {
+    if (which_entities_.apply_on(grid_view, entity))
+      static_apply(functor_, entity, 0);
+  }
+
+  template< class GridViewType, class IntersectionType, class EntityType >
+  void apply_local(const GridViewType& grid_view,
+                   const IntersectionType& intersection,
+                   const EntityType& inside_entity,
+                   const EntityType& outside_entity)
+  {
+    if (which_intersections_.apply_on(grid_view, intersection))
+      static_apply(functor_, intersection, inside_entity, outside_entity, 0);
+  }
+
+  void finalize()
+  {
+    static_finalize(functor_, 0);
+  }
+
+private:
+  FunctorImp functor_;
+  const WhichEntityImp which_entities_;
+  const WhichIntersectionImp which_intersections_;
+}; // class StaticCodim0And1Entry
+
+
+template< size_t ii, size_t size >
+struct StaticForEach
+{
+  template< class TupleType, class OperationType >
+  static void apply(TupleType& tuple, const OperationType& operation)
+  {
+    operation(std::get< ii >(tuple));
+    StaticForEach< ii + 1, size >::apply(tuple, operation);
+  }
+}; // struct StaticForEach
+
+template< size_t size >
+struct StaticForEach< size, size >
+{
+  template< class TupleType, class OperationType >
+  static void apply(TupleType& /*tuple*/, const OperationType& /*operation*/)
+  {}
+}; // struct StaticForEach< size, size >
+
+
+template< class... EntryTypes >
+struct StaticAnyCodim1
+  : public std::false_type
+{};
+
+template< class EntryType, class... EntryTypes >
+struct StaticAnyCodim1< EntryType, EntryTypes... >
+  : public std::integral_constant< bool, EntryType::codim1 || StaticAnyCodim1< EntryTypes... >::value >
+{};
+
+
+} // namespace internal
+
+
+/**
+ *  \brief Selects the entities functor is applied on in a StaticWalker.
+ *
+ *  functor may either provide apply_local(entity) (e.g. a Functor::Codim0) or be callable with an entity (e.g. a
+ *  lambda), prepare() and finalize() are called if present. where may be any type providing
+ *  apply_on(grid_view, entity), e.g. the ApplyOn classes. If an lvalue is given, the functor is held by reference.
+ */
+template< class FunctorType, class WhichEntityType = internal::StaticApplyOnAll >
+internal::StaticCodim0Entry< FunctorType, WhichEntityType > on_entities(FunctorType&& functor,
+                                                                        const WhichEntityType& where = WhichEntityType())
+{
+  return internal::StaticCodim0Entry< FunctorType, WhichEntityType >(std::forward< FunctorType >(functor), where);
+}
+
+//! \see on_entities
+template< class FunctorType, class WhichIntersectionType = internal::StaticApplyOnAll >
+internal::StaticCodim1Entry< FunctorType, WhichIntersectionType >
+on_intersections(FunctorType&& functor, const WhichIntersectionType& where = WhichIntersectionType())
+{
+  return internal::StaticCodim1Entry< FunctorType, WhichIntersectionType >(std::forward< FunctorType >(functor), where);
+}
+
+//! \see on_entities
+template< class FunctorType,
+          class WhichEntityType = internal::StaticApplyOnAll,
+          class WhichIntersectionType = internal::StaticApplyOnAll >
+internal::StaticCodim0And1Entry< FunctorType, WhichEntityType, WhichIntersectionType >
+on_entities_and_intersections(FunctorType&& functor,
+                              const WhichEntityType& which_entities = WhichEntityType(),
+                              const WhichIntersectionType& which_intersections = WhichIntersectionType())
+{
+  return internal::StaticCodim0And1Entry< FunctorType, WhichEntityType, WhichIntersectionType >(
+        std::forward< FunctorType >(functor), which_entities, which_intersections);
+}
+
+
+/**
+ *  \brief A Walker whose functors and filters are fixed at compile time.
+ *
+ *         Offers the same prepare(), apply_local() and finalize() semantics as Walker, but without any virtual calls or
+ *         heap allocations, so the compiler can inline the whole per entity call chain. Use make_static_walker() and
+ *         on_entities(), on_intersections() or on_entities_and_intersections() to create one:
+\code
+Functor::Codim0And1< GridViewType >& local_assembler = ...;
+size_t boundary_count = 0;
+auto walker = make_static_walker(grid_view,
+                                 on_entities_and_intersections(local_assembler),
+                                 on_intersections([&](const IntersectionType&, const EntityType&, const EntityType&)
+                                                  { ++boundary_count; },
+                                                  ApplyOn::BoundaryIntersections< GridViewType >()));
+walker.walk();
+\endcode
+ *         Since the ApplyOn classes mark apply_on() final, calling them on a known type does not involve virtual
+ *         dispatch.
+ */
+template< class GridViewImp, class... EntryTypes >
+class StaticWalker
+{
+  typedef std::tuple< EntryTypes... > EntriesType;
+  static const size_t num_entries = sizeof...(EntryTypes);
+
+  struct Prepare
+  {
+    template< class EntryType >
+    void operator()(EntryType& entry) const
+    {
+      entry.prepare();
+    }
+  };
+
+  struct Finalize
+  {
+    template< class EntryType >
+    void operator()(EntryType& entry) const
+    {
+      entry.finalize();
+    }
+  };
+
+public:
+  typedef GridViewImp GridViewType;
+  typedef typename Stuff::Grid::Entity< GridViewType >::Type       EntityType;
+  typedef typename Stuff::Grid::Intersection< GridViewType >::Type IntersectionType;
+
+private:
+  struct ApplyOnEntity
+  {
+    template< class EntryType >
+    void operator()(EntryType& entry) const
+    {
+      entry.apply_local(grid_view_, entity_);
+    }
+
+    const GridViewType& grid_view_;
+    const EntityType& entity_;
+  };
+
+  struct ApplyOnIntersection
+  {
+    template< class EntryType >
+    void operator()(EntryType& entry) const
+    {
+      entry.apply_local(grid_view_, intersection_, inside_entity_, outside_entity_);
+    }
+
+    const GridViewType& grid_view_;
+    const IntersectionType& intersection_;
+    const EntityType& inside_entity_;
+    const EntityType& outside_entity_;
+  };
+
+public:
+  explicit StaticWalker(GridViewType grd_vw, EntryTypes... entries)
+    : grid_view_(grd_vw)
+    , entries_(std::move(entries)...)
+  {}
+
+  const GridViewType& grid_view() const
+  {
+    return grid_view_;
+  }
+
+  void prepare()
+  {
+    internal::StaticForEach< 0, num_entries >::apply(entries_, Prepare());
+  }
+
+  void apply_local(const EntityType& entity)
+  {
+    internal::StaticForEach< 0, num_entries >::apply(entries_, ApplyOnEntity{grid_view_, entity});
+  }
+
+  void apply_local(const IntersectionType& intersection,
+                   const EntityType& inside_entity,
+                   const EntityType& outside_entity)
+  {
+    internal::StaticForEach< 0, num_entries >::apply(entries_,
+                                                     ApplyOnIntersection{grid_view_,
+                                                                         intersection,
+                                                                         inside_entity,
+                                                                         outside_entity});
+  } // ... apply_local(...)
+
+  void finalize()
+  {
+    internal::StaticForEach< 0, num_entries >::apply(entries_, Finalize());
+  }
+
+  void walk()
+  {
+    prepare();
+    walk_range(DSC::entityRange(grid_view_));
+    finalize();
+  } // ... walk(...)
+
+  template< class EntityRange >
+  void walk_range(const EntityRange& entity_range)
+  {
+#ifdef __INTEL_COMPILER
+    const auto it_end = entity_range.end();
+    for (auto it = entity_range.begin(); it != it_end; ++it) {
+      const EntityType& entity = *it;
+#else
+    for (const EntityType& entity : entity_range) {
+#endif
+      // apply codim0 functors
+      apply_local(entity);
+
+      // only walk the intersections, if there are codim1 functors present
+      if (internal::StaticAnyCodim1< EntryTypes... >::value) {
+        // walk the intersections
+        const auto intersection_it_end = grid_view_.iend(entity);
+        for (auto intersection_it = grid_view_.ibegin(entity);
+             intersection_it != intersection_it_end;
+             ++intersection_it) {
+          const auto& intersection = *intersection_it;
+
+          // apply codim1 functors
+          if (intersection.neighbor()) {
+            const auto neighbor_ptr = intersection.outside();
+            const auto& neighbor = *neighbor_ptr;
+            apply_local(intersection, entity, neighbor);
+          } else
+            apply_local(intersection, entity, entity);
+
+        } // walk the intersections
+      } // only walk the intersections, if there are codim1 functors present
+    }
+  } // ... walk_range(...)
+
+private:
+  const GridViewType grid_view_;
+  EntriesType entries_;
+}; // class StaticWalker
+
+
+template< class GridViewType, class... EntryTypes >
+StaticWalker< GridViewType, EntryTypes... > make_static_walker(const GridViewType& grid_view, EntryTypes... entries)
+{
+  return StaticWalker< GridViewType, EntryTypes... >(grid_view, std::move(entries)...);
+}
+
+
+} // namespace Grid
+} // namespace Stuff
+} // namespace Dune
+
+#endif // HAVE_DUNE_GRID
+
+#endif // DUNE_STUFF_GRID_WALKER_STATIC_HH
@@ -9,6 +9,11 @@
 //nothing here will compile w/o grid present
 #if HAVE_DUNE_GRID
 
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cassert>
+
 #include "functors.hh"
 #include "apply-on.hh"
 
@@ -18,6 +23,71 @@ namespace Grid {
 namespace internal {
 
 
+template< class GridViewType >
+class Codim0ObjectReference;
+
+template< class GridViewType >
+class Codim1ObjectReference;
+
+
+/**
+ * \brief Holds the clones of all Functor::Codim0And1 of one worker of a parallel walk.
+ *
+ *        Clones are created on first request and kept in that order, which is also the order in which they are joined.
+ */
+template< class GridViewType >
+class Codim0And1Clones
+{
+public:
+  typedef Functor::Codim0And1< GridViewType > FunctorType;
+
+  //! \return the clone of functor, nullptr if functor does not support cloning
+  FunctorType* get(FunctorType& functor)
+  {
+    for (auto& original_and_clone : clones_)
+      if (original_and_clone.first == &functor)
+        return original_and_clone.second.get();
+    auto clone = functor.clone();
+    if (!clone)
+      return nullptr;
+    clones_.emplace_back(&functor, std::move(clone));
+    return clones_.back().second.get();
+  } // ... get(...)
+
+  //! only Functor::Codim0And1 supports cloning
+  template< class OtherFunctorType >
+  OtherFunctorType* get(OtherFunctorType& /*functor*/)
+  {
+    return nullptr;
+  }
+
+  bool empty() const
+  {
+    return clones_.empty();
+  }
+
+  //! merges the clones of other into the corresponding clones of this
+  void join(Codim0And1Clones< GridViewType >& other)
+  {
+    for (auto& original_and_clone : other.clones_) {
+      auto clone = get(*original_and_clone.first);
+      assert(clone);
+      clone->join(*original_and_clone.second);
+    }
+  } // ... join(...)
+
+  //! merges each clone into the functor it was created from
+  void join_into_originals()
+  {
+    for (auto& original_and_clone : clones_)
+      original_and_clone.first->join(*original_and_clone.second);
+  }
+
+private:
+  std::vector< std::pair< FunctorType*, std::unique_ptr< FunctorType > > > clones_;
+}; // class Codim0And1Clones
+
+
 template< class GridViewType >
 class Codim0Object
   : public Functor::Codim0< GridViewType >
@@ -29,9 +99,57 @@ public:
   virtual ~Codim0Object() {}
 
   virtual bool apply_on(const GridViewType& grid_view, const EntityType& entity) const = 0;
+
+  //! \return the filter apply_on() forwards to, nullptr if apply_on() is more involved
+  virtual const ApplyOn::WhichEntity< GridViewType >* filter() const
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Creates the object to be used by a single worker of a parallel walk.
+   *
+   *        The default forwards to this object, i.e. the wrapped functor is shared among all workers.
+   */
+  virtual std::unique_ptr< Codim0Object< GridViewType > > worker_copy(Codim0And1Clones< GridViewType >& /*clones*/)
+  {
+    return std::unique_ptr< Codim0Object< GridViewType > >(new Codim0ObjectReference< GridViewType >(*this));
+  }
 };
 
 
+template< class GridViewType >
+class Codim0ObjectReference
+  : public Codim0Object< GridViewType >
+{
+  typedef Codim0Object< GridViewType > BaseType;
+public:
+  typedef typename BaseType::EntityType EntityType;
+
+  explicit Codim0ObjectReference(BaseType& referenced)
+    : referenced_(referenced)
+  {}
+
+  virtual bool apply_on(const GridViewType& grid_view, const EntityType& entity) const override final
+  {
+    return referenced_.apply_on(grid_view, entity);
+  }
+
+  virtual const ApplyOn::WhichEntity< GridViewType >* filter() const override final
+  {
+    return referenced_.filter();
+  }
+
+  virtual void apply_local(const EntityType& entity) override final
+  {
+    referenced_.apply_local(entity);
+  }
+
+private:
+  BaseType& referenced_;
+}; // class Codim0ObjectReference
+
+
 template<class GridViewType, class Codim0FunctorType>
 class Codim0FunctorWrapper
   : public Codim0Object< GridViewType >
@@ -45,6 +163,14 @@ public:
     , where_(where)
   {}
 
+private:
+  Codim0FunctorWrapper(Codim0FunctorType& wrapped_functor,
+                       std::shared_ptr< const ApplyOn::WhichEntity< GridViewType > > where)
+    : wrapped_functor_(wrapped_functor)
+    , where_(where)
+  {}
+
+public:
   virtual ~Codim0FunctorWrapper() {}
 
   virtual void prepare() override final
@@ -57,6 +183,11 @@ public:
     return where_->apply_on(grid_view, entity);
   }
 
+  virtual const ApplyOn::WhichEntity< GridViewType >* filter() const override final
+  {
+    return where_.get();
+  }
+
   virtual void apply_local(const EntityType& entity) override final
   {
     wrapped_functor_.apply_local(entity);
@@ -67,9 +198,17 @@ public:
     wrapped_functor_.finalize();
   }
 
+  virtual std::unique_ptr< BaseType > worker_copy(Codim0And1Clones< GridViewType >& clones) override final
+  {
+    auto clone = clones.get(wrapped_functor_);
+    if (clone)
+      return std::unique_ptr< BaseType >(new Codim0FunctorWrapper< GridViewType, Codim0FunctorType >(*clone, where_));
+    return BaseType::worker_copy(clones);
+  } // ... worker_copy(...)
+
 private:
   Codim0FunctorType& wrapped_functor_;
-  std::unique_ptr< const ApplyOn::WhichEntity< GridViewType > > where_;
+  std::shared_ptr< const ApplyOn::WhichEntity< GridViewType > > where_;
 }; // class Codim0FunctorWrapper
 
 
@@ -84,9 +223,60 @@ public:
   virtual ~Codim1Object() {}
 
   virtual bool apply_on(const GridViewType& grid_view, const IntersectionType& intersection) const = 0;
+
+  //! \return the filter apply_on() forwards to, nullptr if apply_on() is more involved
+  virtual const ApplyOn::WhichIntersection< GridViewType >* filter() const
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Creates the object to be used by a single worker of a parallel walk.
+   *
+   *        The default forwards to this object, i.e. the wrapped functor is shared among all workers.
+   */
+  virtual std::unique_ptr< Codim1Object< GridViewType > > worker_copy(Codim0And1Clones< GridViewType >& /*clones*/)
+  {
+    return std::unique_ptr< Codim1Object< GridViewType > >(new Codim1ObjectReference< GridViewType >(*this));
+  }
 };
 
 
+template< class GridViewType >
+class Codim1ObjectReference
+  : public Codim1Object< GridViewType >
+{
+  typedef Codim1Object< GridViewType > BaseType;
+public:
+  typedef typename BaseType::EntityType       EntityType;
+  typedef typename BaseType::IntersectionType IntersectionType;
+
+  explicit Codim1ObjectReference(BaseType& referenced)
+    : referenced_(referenced)
+  {}
+
+  virtual bool apply_on(const GridViewType& grid_view, const IntersectionType& intersection) const override final
+  {
+    return referenced_.apply_on(grid_view, intersection);
+  }
+
+  virtual const ApplyOn::WhichIntersection< GridViewType >* filter() const override final
+  {
+    return referenced_.filter();
+  }
+
+  virtual void apply_local(const IntersectionType& intersection,
+                           const EntityType& inside_entity,
+                           const EntityType& outside_entity) override final
+  {
+    referenced_.apply_local(intersection, inside_entity, outside_entity);
+  }
+
+private:
+  BaseType& referenced_;
+}; // class Codim1ObjectReference
+
+
 template<class GridViewType, class Codim1FunctorType>
 class Codim1FunctorWrapper
   : public Codim1Object< GridViewType >
@@ -101,6 +291,15 @@ public:
     , where_(where)
   {}
 
+private:
+  Codim1FunctorWrapper(Codim1FunctorType& wrapped_functor,
+                       std::shared_ptr< const ApplyOn::WhichIntersection< GridViewType > > where)
+    : wrapped_functor_(wrapped_functor)
+    , where_(where)
+  {}
+
+public:
+
   virtual void prepare() override final
   {
     wrapped_functor_.prepare();
@@ -111,6 +310,11 @@ public:
     return where_->apply_on(grid_view, intersection);
   }
 
+  virtual const ApplyOn::WhichIntersection< GridViewType >* filter() const override final
+  {
+    return where_.get();
+  }
+
   virtual void apply_local(const IntersectionType& intersection,
                            const EntityType& inside_entity,
                            const EntityType& outside_entity) override final
@@ -123,9 +327,17 @@ public:
     wrapped_functor_.finalize();
   }
 
+  virtual std::unique_ptr< BaseType > worker_copy(Codim0And1Clones< GridViewType >& clones) override final
+  {
+    auto clone = clones.get(wrapped_functor_);
+    if (clone)
+      return std::unique_ptr< BaseType >(new Codim1FunctorWrapper< GridViewType, Codim1FunctorType >(*clone, where_));
+    return BaseType::worker_copy(clones);
+  } // ... worker_copy(...)
+
 private:
   Codim1FunctorType& wrapped_functor_;
-  std::unique_ptr< const ApplyOn::WhichIntersection< GridViewType > > where_;
+  std::shared_ptr< const ApplyOn::WhichIntersection< GridViewType > > where_;
 }; // class Codim1FunctorWrapper
 
 
@@ -212,6 +424,11 @@ public:
     return where_->apply_on(grid_view, entity);
   }
 
+  virtual const ApplyOn::WhichEntity< GridViewType >* filter() const override final
+  {
+    return where_.get();
+  }
+
   virtual void apply_local(const EntityType& entity) override final
   {
     lambda_(entity);
@@ -242,6 +459,11 @@ public:
     return where_->apply_on(grid_view, intersection);
   }
 
+  virtual const ApplyOn::WhichIntersection< GridViewType >* filter() const override final
+  {
+    return where_.get();
+  }
+
   virtual void apply_local(const IntersectionType& intersection,
                            const EntityType& inside_entity,
                            const EntityType& outside_entity) override final
@@ -30,6 +30,14 @@ struct Container< ScalarType, ChooseBackend::common_dense >
 }; // struct Container< ..., common_dense >
 
 
+template< class ScalarType >
+struct Container< ScalarType, ChooseBackend::common_sparse >
+{
+  typedef CommonDenseVector< ScalarType >     VectorType;
+  typedef CommonSparseMatrixCsr< ScalarType > MatrixType;
+}; // struct Container< ..., common_sparse >
+
+
 template< class ScalarType >
 struct Container< ScalarType, ChooseBackend::eigen_dense >
 {
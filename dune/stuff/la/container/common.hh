@@ -8,6 +8,7 @@
 #ifndef DUNE_STUFF_LA_CONTAINER_COMMON_HH
 #define DUNE_STUFF_LA_CONTAINER_COMMON_HH
 
+#include <algorithm>
 #include <cmath>
 #include <initializer_list>
 #include <memory>
@@ -24,6 +25,7 @@
 #include <dune/common/ftraits.hh>
 
 #include "interfaces.hh"
+#include "kernels.hh"
 #include "pattern.hh"
 
 namespace Dune {
@@ -38,6 +40,9 @@ class CommonDenseVector;
 template< class ScalarImp >
 class CommonDenseMatrix;
 
+template< class ScalarImp >
+class CommonSparseMatrixCsr;
+
 
 namespace internal {
 
@@ -65,6 +70,40 @@ public:
 };
 
 
+/**
+ * \brief The compressed sparse row (CSR) storage of CommonSparseMatrixCsr.
+ *
+ *        The entries of row ii are entries[kk] in column column_indices[kk] for row_pointers[ii] <= kk <
+ *        row_pointers[ii + 1], the column indices of each row are sorted and unique.
+ */
+template< class ScalarImp >
+struct CsrStorage
+{
+  explicit CsrStorage(const size_t rr = 0, const size_t cc = 0)
+    : num_rows(rr)
+    , num_cols(cc)
+    , row_pointers(rr + 1, 0)
+  {}
+
+  size_t num_rows;
+  size_t num_cols;
+  std::vector< size_t > row_pointers;
+  std::vector< size_t > column_indices;
+  std::vector< ScalarImp > entries;
+}; // struct CsrStorage
+
+
+template< class ScalarImp = double >
+class CommonSparseMatrixCsrTraits
+{
+public:
+  typedef typename Dune::FieldTraits< ScalarImp >::field_type ScalarType;
+  typedef typename Dune::FieldTraits< ScalarImp >::real_type  RealType;
+  typedef CommonSparseMatrixCsr< ScalarType >                 derived_type;
+  typedef CsrStorage< ScalarType >                            BackendType;
+};
+
+
 } // namespace internal
 
 
@@ -79,6 +118,7 @@ class CommonDenseVector
 {
   typedef CommonDenseVector< ScalarImp >                                               ThisType;
   typedef VectorInterface< internal::CommonDenseVectorTraits< ScalarImp >, ScalarImp > VectorInterfaceType;
+  typedef internal::ChunkedContiguousKernels< ScalarImp >                              KernelsType;
   static_assert(!std::is_same< DUNE_STUFF_SSIZE_T, int >::value,
                 "You have to manually disable the constructor below which uses DUNE_STUFF_SSIZE_T!");
 public:
@@ -144,9 +184,7 @@ public:
 
   ThisType& operator=(const ScalarType& value)
   {
-    ensure_uniqueness();
-    for (auto& element : *this)
-      element = value;
+    std::fill_n(entries(), size(), value);
     return *this;
   } // ... operator=(...)
 
@@ -159,6 +197,15 @@ public:
     return *this;
   }
 
+  /**
+   *  \see VectorInterface::assign()
+   */
+  template< class E >
+  ThisType& operator=(const VectorExpression< E, ThisType >& expression)
+  {
+    return this->assign(expression);
+  }
+
   /// \name Required by the ProvidesBackend interface.
   /// \{
 
@@ -170,7 +217,6 @@ public:
 
   const BackendType& backend() const
   {
-    ensure_uniqueness();
     return *backend_;
   } // ... backend(...)
 
@@ -180,7 +226,12 @@ public:
 
   ScalarType* data()
   {
-    return &(backend()[0]);
+    return entries();
+  }
+
+  const ScalarType* data() const
+  {
+    return entries();
   }
 
   /// \}
@@ -194,7 +245,7 @@ public:
 
   void scal(const ScalarType& alpha)
   {
-    backend() *= alpha;
+    KernelsType::scal(alpha, entries(), size());
   } // ... scal(...)
 
   void axpy(const ScalarType& alpha, const ThisType& xx)
@@ -202,11 +253,8 @@ public:
     if (xx.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of x (" << xx.size() << ") does not match the size of this (" << size() << ")!");
-    ensure_uniqueness();
-    auto& this_ref = *backend_;
-    const auto& xx_ref = *(xx.backend_);
-    for (size_t ii = 0; ii < this_ref.size(); ++ii)
-      this_ref[ii] += alpha * xx_ref[ii];
+    ScalarType* yy = entries();
+    KernelsType::axpy(alpha, xx.entries(), yy, size());
   } // ... axpy(...)
 
   bool has_equal_shape(const ThisType& other) const
@@ -264,22 +312,22 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    return backend_->operator*(*(other.backend_));
+    return KernelsType::dot(entries(), other.entries(), size());
   } // ... dot(...)
 
   virtual RealType l1_norm() const override final
   {
-    return backend_->one_norm();
+    return KernelsType::l1_norm(entries(), size());
   }
 
   virtual RealType l2_norm() const override final
   {
-    return backend_->two_norm();
+    return KernelsType::l2_norm(entries(), size());
   }
 
   virtual RealType sup_norm() const override final
   {
-    return backend_->infinity_norm();
+    return KernelsType::sup_norm(entries(), size());
   }
 
   virtual void add(const ThisType& other, ThisType& result) const override final
@@ -290,9 +338,8 @@ public:
     if (result.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of result (" << result.size() << ") does not match the size of this (" << size() << ")!");
-    BackendType& result_ref = result.backend();
-    for (size_t ii = 0; ii < size(); ++ii)
-      result_ref[ii] = backend_->operator[](ii) + other.backend_->operator[](ii);
+    ScalarType* result_entries = result.entries();
+    KernelsType::add(entries(), other.entries(), result_entries, size());
   } // ... add(...)
 
   virtual void iadd(const ThisType& other) override final
@@ -300,7 +347,8 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    backend() += *(other.backend_);
+    ScalarType* this_entries = entries();
+    KernelsType::add(this_entries, other.entries(), this_entries, size());
   } // ... iadd(...)
 
   virtual void sub(const ThisType& other, ThisType& result) const override final
@@ -311,9 +359,8 @@ public:
     if (result.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of result (" << result.size() << ") does not match the size of this (" << size() << ")!");
-    BackendType& result_ref = result.backend();
-    for (size_t ii = 0; ii < size(); ++ii)
-      result_ref[ii] = backend_->operator[](ii) - other.backend_->operator[](ii);
+    ScalarType* result_entries = result.entries();
+    KernelsType::sub(entries(), other.entries(), result_entries, size());
   } // ... sub(...)
 
   virtual void isub(const ThisType& other) override final
@@ -321,7 +368,8 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    backend() -= *(other.backend_);
+    ScalarType* this_entries = entries();
+    KernelsType::sub(this_entries, other.entries(), this_entries, size());
   } // ... isub(...)
 
   /// \}
@@ -343,6 +391,19 @@ private:
       backend_ = std::make_shared< BackendType >(*backend_);
   } // ... ensure_uniqueness(...)
 
+  //! \return a pointer to the first entry (nullptr if the vector is empty), for the KernelsType
+  const ScalarType* entries() const
+  {
+    return backend_->size() > 0 ? &(backend_->operator[](0)) : nullptr;
+  }
+
+  //! \see entries() const, ensures uniqueness
+  ScalarType* entries()
+  {
+    ensure_uniqueness();
+    return backend_->size() > 0 ? &(backend_->operator[](0)) : nullptr;
+  }
+
   friend class VectorInterface< internal::CommonDenseVectorTraits< ScalarType >, ScalarType >;
   friend class CommonDenseMatrix< ScalarType >;
 
@@ -454,7 +515,6 @@ public:
 
   const BackendType& backend() const
   {
-    ensure_uniqueness();
     return *backend_;
   }
 
@@ -607,6 +667,379 @@ private:
 }; // class CommonDenseMatrix
 
 
+/**
+ * \brief A sparse matrix implementation of MatrixInterface using the compressed sparse row (CSR) format.
+ *
+ *        This needs neither dune-istl nor eigen. The sparsity pattern is fixed on construction, writing to an entry
+ *        which is not contained in the pattern throws.
+ */
+template< class ScalarImp = double >
+class CommonSparseMatrixCsr
+  : public MatrixInterface< internal::CommonSparseMatrixCsrTraits< ScalarImp >, ScalarImp >
+  , public ProvidesBackend< internal::CommonSparseMatrixCsrTraits< ScalarImp > >
+{
+  typedef CommonSparseMatrixCsr< ScalarImp >                                                ThisType;
+  typedef MatrixInterface< internal::CommonSparseMatrixCsrTraits< ScalarImp >, ScalarImp > MatrixInterfaceType;
+  static_assert(!std::is_same< DUNE_STUFF_SSIZE_T, int >::value,
+                "You have to manually disable the constructor below which uses DUNE_STUFF_SSIZE_T!");
+public:
+  typedef internal::CommonSparseMatrixCsrTraits< ScalarImp > Traits;
+  typedef typename Traits::BackendType                       BackendType;
+  typedef typename Traits::ScalarType                        ScalarType;
+  typedef typename Traits::RealType                          RealType;
+
+private:
+  typedef internal::ChunkedContiguousKernels< ScalarType > KernelsType;
+
+public:
+  /**
+   * \brief This is the constructor of interest which creates a sparse matrix with all entries of pattern set to 0.
+   */
+  CommonSparseMatrixCsr(const size_t rr, const size_t cc, const SparsityPatternDefault& pattern)
+    : backend_(new BackendType(rr, cc))
+  {
+    if (pattern.size() != rr)
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "The size of the pattern (" << pattern.size()
+                 << ") does not match the number of rows of this (" << rr << ")!");
+    BackendType& storage = *backend_;
+    for (size_t ii = 0; ii < rr; ++ii) {
+      auto columns = pattern.inner(ii);
+      std::sort(columns.begin(), columns.end());
+      columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+      if (!columns.empty() && columns.back() >= cc)
+        DUNE_THROW(Exceptions::shapes_do_not_match,
+                   "The size of row " << ii << " of the pattern does not match the number of columns of this ("
+                   << cc << ")!");
+      storage.column_indices.insert(storage.column_indices.end(), columns.begin(), columns.end());
+      storage.row_pointers[ii + 1] = storage.column_indices.size();
+    }
+    storage.entries.resize(storage.column_indices.size(), ScalarType(0));
+  } // CommonSparseMatrixCsr(...)
+
+  //! Creates a matrix with an empty pattern.
+  explicit CommonSparseMatrixCsr(const size_t rr = 0, const size_t cc = 0)
+    : backend_(new BackendType(rr, cc))
+  {}
+
+  /// This constructor is needed for the python bindings.
+  explicit CommonSparseMatrixCsr(const DUNE_STUFF_SSIZE_T rr, const DUNE_STUFF_SSIZE_T cc = 0)
+    : backend_(new BackendType(internal::boost_numeric_cast< size_t >(rr), internal::boost_numeric_cast< size_t >(cc)))
+  {}
+
+  explicit CommonSparseMatrixCsr(const int rr, const int cc = 0)
+    : backend_(new BackendType(internal::boost_numeric_cast< size_t >(rr), internal::boost_numeric_cast< size_t >(cc)))
+  {}
+
+  CommonSparseMatrixCsr(const ThisType& other)
+    : backend_(other.backend_)
+  {}
+
+  explicit CommonSparseMatrixCsr(const BackendType& other,
+                                 const bool prune = false,
+                                 const typename Common::FloatCmp::DefaultEpsilon< ScalarType >::Type eps
+                                  = Common::FloatCmp::DefaultEpsilon< ScalarType >::value())
+  {
+    if (prune)
+      backend_ = ThisType(other).pruned(eps).backend_;
+    else
+      backend_ = std::make_shared< BackendType >(other);
+  }
+
+  /**
+   *  \note Takes ownership of backend_ptr in the sense that you must not delete it afterwards!
+   */
+  explicit CommonSparseMatrixCsr(BackendType* backend_ptr)
+    : backend_(backend_ptr)
+  {}
+
+  explicit CommonSparseMatrixCsr(std::shared_ptr< BackendType > backend_ptr)
+    : backend_(backend_ptr)
+  {}
+
+  ThisType& operator=(const ThisType& other)
+  {
+    backend_ = other.backend_;
+    return *this;
+  }
+
+  /**
+   *  \note Does a deep copy.
+   */
+  ThisType& operator=(const BackendType& other)
+  {
+    backend_ = std::make_shared< BackendType >(other);
+    return *this;
+  }
+
+  /// \name Required by the ProvidesBackend interface.
+  /// \{
+
+  BackendType& backend()
+  {
+    ensure_uniqueness();
+    return *backend_;
+  }
+
+  const BackendType& backend() const
+  {
+    return *backend_;
+  }
+
+  /// \}
+  /// \name Required by ContainerInterface.
+  /// \{
+
+  ThisType copy() const
+  {
+    return ThisType(*backend_);
+  }
+
+  void scal(const ScalarType& alpha)
+  {
+    auto& entries = backend().entries;
+    KernelsType::scal(alpha, entries.data(), entries.size());
+  }
+
+  /**
+   * \note If the patterns of this and xx differ, all entries of xx have to be contained in the pattern of this.
+   */
+  void axpy(const ScalarType& alpha, const ThisType& xx)
+  {
+    if (!has_equal_shape(xx))
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "The shape of xx (" << xx.rows() << "x" << xx.cols()
+                 << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    const BackendType& xx_ref = *(xx.backend_);
+    if (backend_ == xx.backend_
+        || (backend_->row_pointers == xx_ref.row_pointers && backend_->column_indices == xx_ref.column_indices)) {
+      auto& entries = backend().entries;
+      KernelsType::axpy(alpha, xx_ref.entries.data(), entries.data(), entries.size());
+    } else {
+      BackendType& storage = backend();
+      for (size_t ii = 0; ii < rows(); ++ii)
+        for (size_t kk = xx_ref.row_pointers[ii]; kk < xx_ref.row_pointers[ii + 1]; ++kk)
+          storage.entries[existing_position(ii, xx_ref.column_indices[kk])] += alpha * xx_ref.entries[kk];
+    }
+  } // ... axpy(...)
+
+  bool has_equal_shape(const ThisType& other) const
+  {
+    return (rows() == other.rows()) && (cols() == other.cols());
+  }
+
+  /// \}
+  /// \name Required by MatrixInterface.
+  /// \{
+
+  inline size_t rows() const
+  {
+    return backend_->num_rows;
+  }
+
+  inline size_t cols() const
+  {
+    return backend_->num_cols;
+  }
+
+  inline void mv(const VectorInterface< internal::CommonDenseVectorTraits< ScalarType >, ScalarType >& xx,
+                 VectorInterface< internal::CommonDenseVectorTraits< ScalarType >, ScalarType >& yy) const
+  {
+    mv(xx.as_imp(), yy.as_imp());
+  }
+
+  /**
+   * \brief Computes yy = A * xx.
+   *
+   *        The rows are processed in blocks holding vector_chunk_size entries of this (see internal::for_each_chunk()),
+   *        so that the entries and column indices of each block stay in the cache, the blocks are processed in parallel
+   *        for large matrices. Each entry of yy is always summed up in the same order, the result thus does not depend
+   *        on the number of threads.
+   */
+  void mv(const CommonDenseVector< ScalarType >& xx, CommonDenseVector< ScalarType >& yy) const
+  {
+    if (xx.size() != cols())
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "The size of xx (" << xx.size() << ") does not match the number of columns of this (" << cols()
+                 << ")!");
+    if (yy.size() != rows())
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "The size of yy (" << yy.size() << ") does not match the number of rows of this (" << rows()
+                 << ")!");
+    if (&xx == &yy) {
+      mv(xx.copy(), yy);
+      return;
+    }
+    ScalarType* yy_entries = yy.data();
+    const ScalarType* xx_entries = xx.data();
+    const BackendType& storage = *backend_;
+    const size_t num_rows = storage.num_rows;
+    const size_t num_entries = storage.entries.size();
+    internal::for_each_chunk(num_entries, [&](const size_t begin, const size_t end) {
+      // row ii belongs to the block which contains its first entry
+      const auto row_pointers_begin = storage.row_pointers.begin();
+      const size_t first_row = std::lower_bound(row_pointers_begin, row_pointers_begin + num_rows, begin)
+                               - row_pointers_begin;
+      const size_t last_row = (end == num_entries)
+                              ? num_rows
+                              : std::lower_bound(row_pointers_begin, row_pointers_begin + num_rows, end)
+                                - row_pointers_begin;
+      for (size_t ii = first_row; ii < last_row; ++ii) {
+        ScalarType sum(0);
+        for (size_t kk = storage.row_pointers[ii]; kk < storage.row_pointers[ii + 1]; ++kk)
+          sum += storage.entries[kk] * xx_entries[storage.column_indices[kk]];
+        yy_entries[ii] = sum;
+      }
+    });
+  } // ... mv(...)
+
+  void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
+  {
+    assert(ii < rows());
+    assert(jj < cols());
+    const size_t kk = existing_position(ii, jj);
+    backend().entries[kk] += value;
+  } // ... add_to_entry(...)
+
+  void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
+  {
+    assert(ii < rows());
+    assert(jj < cols());
+    const size_t kk = existing_position(ii, jj);
+    backend().entries[kk] = value;
+  } // ... set_entry(...)
+
+  ScalarType get_entry(const size_t ii, const size_t jj) const
+  {
+    assert(ii < rows());
+    assert(jj < cols());
+    const size_t kk = position(ii, jj);
+    return (kk < backend_->entries.size()) ? backend_->entries[kk] : ScalarType(0);
+  } // ... get_entry(...)
+
+  void clear_row(const size_t ii)
+  {
+    if (ii >= rows())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Given ii (" << ii << ") is larger than the rows of this (" << rows() << ")!");
+    BackendType& storage = backend();
+    std::fill(storage.entries.begin() + storage.row_pointers[ii],
+              storage.entries.begin() + storage.row_pointers[ii + 1],
+              ScalarType(0));
+  } // ... clear_row(...)
+
+  void clear_col(const size_t jj)
+  {
+    if (jj >= cols())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Given jj (" << jj << ") is larger than the cols of this (" << cols() << ")!");
+    BackendType& storage = backend();
+    for (size_t ii = 0; ii < rows(); ++ii) {
+      const size_t kk = position(ii, jj);
+      if (kk < storage.entries.size())
+        storage.entries[kk] = ScalarType(0);
+    }
+  } // ... clear_col(...)
+
+  void unit_row(const size_t ii)
+  {
+    if (ii >= cols())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Given ii (" << ii << ") is larger than the cols of this (" << cols() << ")!");
+    if (ii >= rows())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Given ii (" << ii << ") is larger than the rows of this (" << rows() << ")!");
+    const size_t diagonal = existing_position(ii, ii);
+    clear_row(ii);
+    backend_->entries[diagonal] = ScalarType(1);
+  } // ... unit_row(...)
+
+  void unit_col(const size_t jj)
+  {
+    if (jj >= cols())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Given jj (" << jj << ") is larger than the cols of this (" << cols() << ")!");
+    if (jj >= rows())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Given jj (" << jj << ") is larger than the rows of this (" << rows() << ")!");
+    const size_t diagonal = existing_position(jj, jj);
+    clear_col(jj);
+    backend_->entries[diagonal] = ScalarType(1);
+  } // ... unit_col(...)
+
+  bool valid() const
+  {
+    for (const auto& entry : backend_->entries)
+      if (Common::isnan(entry) || Common::isinf(entry))
+        return false;
+    return true;
+  } // ... valid(...)
+
+  /// \}
+  /// \name These methods override default implementations from MatrixInterface.
+  /// \{
+
+  virtual RealType sup_norm() const override final
+  {
+    return KernelsType::sup_norm(backend_->entries.data(), backend_->entries.size());
+  }
+
+  virtual size_t non_zeros() const override final
+  {
+    return backend_->entries.size();
+  }
+
+  virtual SparsityPatternDefault pattern(const bool prune = false,
+                                         const typename Common::FloatCmp::DefaultEpsilon< ScalarType >::Type eps
+                                            = Common::FloatCmp::DefaultEpsilon< ScalarType >::value()) const override
+  {
+    const BackendType& storage = *backend_;
+    SparsityPatternDefault ret(rows());
+    for (size_t ii = 0; ii < rows(); ++ii) {
+      auto& columns = ret.inner(ii);
+      for (size_t kk = storage.row_pointers[ii]; kk < storage.row_pointers[ii + 1]; ++kk)
+        if (!prune
+            || Common::FloatCmp::ne< Common::FloatCmp::Style::absolute >(storage.entries[kk], ScalarType(0), eps))
+          columns.push_back(storage.column_indices[kk]);
+    }
+    return ret;
+  } // ... pattern(...)
+
+  /// \}
+
+private:
+  //! \return the position of entry (ii, jj) in the entries of the backend, non_zeros() if it is not in the pattern
+  size_t position(const size_t ii, const size_t jj) const
+  {
+    const auto& column_indices = backend_->column_indices;
+    const auto row_begin = column_indices.begin() + backend_->row_pointers[ii];
+    const auto row_end = column_indices.begin() + backend_->row_pointers[ii + 1];
+    const auto column = std::lower_bound(row_begin, row_end, jj);
+    return (column != row_end && *column == jj) ? size_t(column - column_indices.begin()) : column_indices.size();
+  } // ... position(...)
+
+  size_t existing_position(const size_t ii, const size_t jj) const
+  {
+    const size_t kk = position(ii, jj);
+    if (kk == backend_->entries.size())
+      DUNE_THROW(Exceptions::index_out_of_range,
+                 "Entry (" << ii << ", " << jj << ") is not contained in the sparsity pattern!");
+    return kk;
+  } // ... existing_position(...)
+
+  /**
+   * \see ContainerInterface
+   */
+  inline void ensure_uniqueness() const
+  {
+    if (!backend_.unique())
+      backend_ = std::make_shared< BackendType >(*backend_);
+  } // ... ensure_uniqueness(...)
+
+  mutable std::shared_ptr< BackendType > backend_;
+}; // class CommonSparseMatrixCsr
+
+
 } // namespace LA
 namespace Common {
 
@@ -623,6 +1056,12 @@ struct MatrixAbstraction< LA::CommonDenseMatrix< T > >
 {};
 
 
+template< class T >
+struct MatrixAbstraction< LA::CommonSparseMatrixCsr< T > >
+  : public LA::internal::MatrixAbstractionBase< LA::CommonSparseMatrixCsr< T > >
+{};
+
+
 } // namespace Common
 } // namespace Stuff
 } // namespace Dune
@@ -28,6 +28,7 @@ enum class ChooseBackend {
   , istl_sparse
   , eigen_dense
   , eigen_sparse
+  , common_sparse
 }; // enum class ChooseBackend
 
 
@@ -47,8 +48,7 @@ static constexpr ChooseBackend default_sparse_backend =
 #elif HAVE_DUNE_ISTL
                                                         ChooseBackend::istl_sparse;
 #else
-                                                        ChooseBackend::common_dense;
-# error "There is no sparse LA backend available!"
+                                                        ChooseBackend::common_sparse;
 #endif
 
 
@@ -122,9 +122,9 @@ public:
  *
  * \note  All derived classes are supposed to implement copy-on-write. This can be achieved by internally holding a
  *        shared_prt to the appropriate backend and by passing this shared_prt around on copy, move or assingment. Any
- *        class method that writes to the backend or exposes a reference to the backend is then required to make a deep
- *        copy of the backend, if it is not the sole owner of this resource. This can for instance be achieved by
- *        calling a private method:
+ *        class method that writes to the backend or exposes a non-const reference to the backend is then required to
+ *        make a deep copy of the backend, if it is not the sole owner of this resource. This can for instance be
+ *        achieved by calling a private method:
 \code
   inline void ensure_uniqueness() const
   {
@@ -132,6 +132,11 @@ public:
       backend_ = std::make_shared< BackendType >(*backend_);
   }
 \endcode
+ *        Const methods (including backend() const, data() const and get_entry_ref() const) only read and must never
+ *        copy, so reading a shared container is always cheap (and may be done from several threads). References
+ *        obtained from them stay valid until the container is modified. Methods writing to many entries should ensure
+ *        uniqueness once and then work on the backend (or the raw array, see MutableDataView) instead of calling
+ *        set_entry() or add_to_entry() in a loop.
  */
 template< class Traits, class ScalarImp = typename Traits::ScalarType >
 class ContainerInterface
@@ -280,14 +285,67 @@ class ProvidesDataAccess
 public:
   typedef typename Traits::ScalarType ScalarType;
 
+  /**
+   * \brief Writable access to the entries, ensures uniqueness (see ContainerInterface).
+   * \note  Call this once before a loop, not within.
+   */
   inline ScalarType* data()
   {
     CHECK_CRTP(this->as_imp().data());
     return this->as_imp().data();
   }
+
+  //! Read-only access to the entries, never copies.
+  inline const ScalarType* data() const
+  {
+    CHECK_CRTP(this->as_imp().data());
+    return this->as_imp().data();
+  }
 }; // class ProvidesDataAccess
 
 
+/**
+ * \brief Scoped write access to the entries of a container which provides data access.
+ *
+ *        Uniqueness of the container (see ContainerInterface) is ensured once on construction, all accesses afterwards
+ *        go to the raw array, e.g.
+\code
+{
+  MutableDataView< VectorType > view(vector);
+  for (size_t ii = 0; ii < local_size; ++ii)
+    view[global_indices[ii]] += local_values[ii];
+}
+\endcode
+ * \attention The container must not be copied, assigned to or resized while the view exists, the view would write to
+ *            entries which are shared with other containers or have been freed.
+ */
+template< class ContainerImp >
+class MutableDataView
+{
+  static_assert(std::is_base_of< Tags::ProvidesDataAccess, ContainerImp >::value,
+                "ContainerImp has to provide data access!");
+public:
+  typedef typename ContainerImp::ScalarType ScalarType;
+
+  explicit MutableDataView(ContainerImp& container)
+    : entries_(container.data())
+  {}
+
+  inline ScalarType& operator[](const size_t ii) const
+  {
+    return entries_[ii];
+  }
+
+  inline ScalarType* data() const
+  {
+    return entries_;
+  }
+
+private:
+  ScalarType* const entries_;
+}; // class MutableDataView
+
+
 } // namespace LA
 } // namespace Stuff
 } // namespace Dune
@@ -6,6 +6,8 @@
 #ifndef DUNE_STUFF_LA_CONTAINER_EIGEN_BASE_HH
 #define DUNE_STUFF_LA_CONTAINER_EIGEN_BASE_HH
 
+#include <cmath>
+#include <functional>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -72,12 +74,19 @@ public:
 
   VectorImpType& operator=(const ScalarType& value)
   {
-    ensure_uniqueness();
-    for (auto& element : *this)
-      element = value;
+    backend().setConstant(value);
     return this->as_imp();
   } // ... operator=(...)
 
+  /**
+   *  \see VectorInterface::assign()
+   */
+  template< class E >
+  VectorImpType& operator=(const VectorExpression< E, VectorImpType >& expression)
+  {
+    return this->assign(expression);
+  }
+
   /// \name Required by the ProvidesBackend interface.
   /// \{
 
@@ -89,7 +98,6 @@ public:
 
   const BackendType& backend() const
   {
-    ensure_uniqueness();
     return *backend_;
   }
 
@@ -104,8 +112,11 @@ public:
 
   void scal(const ScalarType& alpha)
   {
-    backend() *= alpha;
-  }
+    auto& this_ref = backend();
+    internal::for_each_chunk(size(), [&](const size_t begin, const size_t end) {
+      this_ref.segment(begin, end - begin) *= alpha;
+    });
+  } // ... scal(...)
 
   template< class T >
   void axpy(const ScalarType& alpha, const EigenBaseVector< T, ScalarType >& xx)
@@ -113,7 +124,11 @@ public:
     if (xx.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of xx (" << xx.size() << ") does not match the size of this (" << size() << ")!");
-    backend() += alpha * xx.backend();
+    auto& this_ref = backend();
+    const auto& xx_ref = xx.backend();
+    internal::for_each_chunk(size(), [&](const size_t begin, const size_t end) {
+      this_ref.segment(begin, end - begin) += alpha * xx_ref.segment(begin, end - begin);
+    });
   } // ... axpy(...)
 
   bool has_equal_shape(const VectorImpType& other) const
@@ -156,7 +171,7 @@ protected:
 
   inline const ScalarType& get_entry_ref(const size_t ii) const
   {
-    return backend()[ii];
+    return backend_->operator[](ii);
   }
 
   /// \}
@@ -167,20 +182,23 @@ public:
 
   virtual std::pair< size_t, RealType > amax() const override final
   {
-    auto result = std::make_pair(size_t(0), RealType(0));
-    size_t min_index = 0;
-    size_t max_index = 0;
-    const RealType minimum = (backend_->cwiseAbs()).minCoeff(&min_index);
-    const RealType maximum = (backend_->cwiseAbs()).maxCoeff(&max_index);
-    if (maximum < minimum
-        || (Common::FloatCmp::eq(maximum, minimum) && max_index > min_index)) {
-      result.first = min_index;
-      result.second = minimum;
-    } else {
-      result.first = max_index;
-      result.second = maximum;
-    }
-    return result;
+    const auto& this_ref = *backend_;
+    // maxCoeff() returns the lowest index at which the maximum is attained, so does the join
+    return internal::reduce_chunks(size(),
+                                   [&](const size_t begin, const size_t end) {
+                                     auto result = std::make_pair(begin, RealType(0));
+                                     if (end > begin) {
+                                       size_t max_index = 0;
+                                       const auto segment = this_ref.segment(begin, end - begin);
+                                       result.second = segment.cwiseAbs().maxCoeff(&max_index);
+                                       result.first += max_index;
+                                     }
+                                     return result;
+                                   },
+                                   [](const std::pair< size_t, RealType >& left,
+                                      const std::pair< size_t, RealType >& right) {
+                                     return right.second > left.second ? right : left;
+                                   });
   } // ... amax(...)
 
   template< class T >
@@ -189,7 +207,14 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    return backend_->transpose() * *(other.backend_);
+    const auto& this_ref = *backend_;
+    const auto& other_ref = *(other.backend_);
+    return internal::reduce_chunks(size(),
+                                   [&](const size_t begin, const size_t end) {
+                                     return ScalarType(this_ref.segment(begin, end - begin)
+                                                       .cwiseProduct(other_ref.segment(begin, end - begin)).sum());
+                                   },
+                                   std::plus< ScalarType >());
   } // ... dot(...)
 
   virtual ScalarType dot(const VectorImpType& other) const override final
@@ -199,17 +224,27 @@ public:
 
   virtual RealType l1_norm() const override final
   {
-    return backend_->template lpNorm< 1 >();
-  }
+    const auto& this_ref = *backend_;
+    return internal::reduce_chunks(size(),
+                                   [&](const size_t begin, const size_t end) {
+                                     return RealType(this_ref.segment(begin, end - begin).template lpNorm< 1 >());
+                                   },
+                                   std::plus< RealType >());
+  } // ... l1_norm(...)
 
   virtual RealType l2_norm() const override final
   {
-    return backend_->template lpNorm< 2 >();
-  }
+    const auto& this_ref = *backend_;
+    return std::sqrt(internal::reduce_chunks(size(),
+                                             [&](const size_t begin, const size_t end) {
+                                               return RealType(this_ref.segment(begin, end - begin).squaredNorm());
+                                             },
+                                             std::plus< RealType >()));
+  } // ... l2_norm(...)
 
   virtual RealType sup_norm() const override final
   {
-    return backend_->template lpNorm< ::Eigen::Infinity >();
+    return amax().second;
   }
 
   template< class T1, class T2 >
@@ -221,7 +256,13 @@ public:
     if (result.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of result (" << result.size() << ") does not match the size of this (" << size() << ")!");
-    result.backend() = *backend_ + *(other.backend_);
+    auto& result_ref = result.backend();
+    const auto& this_ref = *backend_;
+    const auto& other_ref = *(other.backend_);
+    internal::for_each_chunk(size(), [&](const size_t begin, const size_t end) {
+      result_ref.segment(begin, end - begin) = this_ref.segment(begin, end - begin)
+                                               + other_ref.segment(begin, end - begin);
+    });
   } // ... add(...)
 
   virtual void add(const VectorImpType& other, VectorImpType& result) const override final
@@ -235,7 +276,11 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    backend() += *(other.backend_);
+    auto& this_ref = backend();
+    const auto& other_ref = *(other.backend_);
+    internal::for_each_chunk(size(), [&](const size_t begin, const size_t end) {
+      this_ref.segment(begin, end - begin) += other_ref.segment(begin, end - begin);
+    });
   } // ... iadd(...)
 
   virtual void iadd(const VectorImpType& other) override final
@@ -252,7 +297,13 @@ public:
     if (result.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of result (" << result.size() << ") does not match the size of this (" << size() << ")!");
-    result.backend() = *backend_ - *(other.backend_);
+    auto& result_ref = result.backend();
+    const auto& this_ref = *backend_;
+    const auto& other_ref = *(other.backend_);
+    internal::for_each_chunk(size(), [&](const size_t begin, const size_t end) {
+      result_ref.segment(begin, end - begin) = this_ref.segment(begin, end - begin)
+                                               - other_ref.segment(begin, end - begin);
+    });
   } // ... sub(...)
 
   virtual void sub(const VectorImpType& other, VectorImpType& result) const override final
@@ -266,7 +317,11 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    backend() -= *(other.backend_);
+    auto& this_ref = backend();
+    const auto& other_ref = *(other.backend_);
+    internal::for_each_chunk(size(), [&](const size_t begin, const size_t end) {
+      this_ref.segment(begin, end - begin) -= other_ref.segment(begin, end - begin);
+    });
   } // ... isub(...)
 
   virtual void isub(const VectorImpType& other) override final
@@ -286,7 +341,6 @@ private:
   void ensure_uniqueness() const
   {
     CHECK_AND_CALL_CRTP(VectorInterfaceType::as_imp().ensure_uniqueness());
-    VectorInterfaceType::as_imp().ensure_uniqueness();
   }
 
 #ifndef NDEBUG
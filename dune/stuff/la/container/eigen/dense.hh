@@ -204,6 +204,11 @@ public:
     return backend().data();
   }
 
+  const ScalarType* data() const
+  {
+    return backend_->data();
+  }
+
   /// \}
 
 private:
@@ -488,7 +493,6 @@ public:
 
   const BackendType& backend() const
   {
-    ensure_uniqueness();
     return *backend_;
   }
 
@@ -497,6 +501,11 @@ public:
   /// \{
 
   ScalarType* data()
+  {
+    return backend().data();
+  }
+
+  const ScalarType* data() const
   {
     return backend_->data();
   }
@@ -8,9 +8,11 @@
 #ifndef DUNE_STUFF_LA_CONTAINER_ISTL_HH
 #define DUNE_STUFF_LA_CONTAINER_ISTL_HH
 
+#include <algorithm>
 #include <vector>
 #include <initializer_list>
 #include <complex>
+#include <type_traits>
 
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -29,6 +31,7 @@
 #include <dune/stuff/common/math.hh>
 
 #include "interfaces.hh"
+#include "kernels.hh"
 #include "pattern.hh"
 
 namespace Dune {
@@ -90,6 +93,7 @@ class IstlDenseVector
 {
   typedef IstlDenseVector< ScalarImp >                                               ThisType;
   typedef VectorInterface< internal::IstlDenseVectorTraits< ScalarImp >, ScalarImp > VectorInterfaceType;
+  typedef internal::ChunkedContiguousKernels< ScalarImp >                            KernelsType;
   static_assert(!std::is_same< DUNE_STUFF_SSIZE_T, int >::value,
                 "You have to manually disable the constructor below which uses DUNE_STUFF_SSIZE_T!");
 public:
@@ -165,14 +169,21 @@ public:
     return *this;
   }
 
+  /**
+   *  \see VectorInterface::assign()
+   */
+  template< class E >
+  ThisType& operator=(const VectorExpression< E, ThisType >& expression)
+  {
+    return this->assign(expression);
+  }
+
   /// \name Required by the ProvidesBackend interface.
   /// \{
 
   ThisType& operator=(const ScalarType& value)
   {
-    ensure_uniqueness();
-    for (auto& element : *this)
-      element = value;
+    std::fill_n(entries(), size(), value);
     return *this;
   }
 
@@ -184,7 +195,6 @@ public:
 
   const BackendType& backend() const
   {
-    ensure_uniqueness();
     return *backend_;
   }
 
@@ -194,7 +204,12 @@ public:
 
   ScalarType* data()
   {
-    return &(backend()[0][0]);
+    return entries();
+  }
+
+  const ScalarType* data() const
+  {
+    return entries();
   }
 
   /// \}
@@ -208,7 +223,7 @@ public:
 
   void scal(const ScalarType& alpha)
   {
-    backend() *= alpha;
+    KernelsType::scal(alpha, entries(), size());
   }
 
   void axpy(const ScalarType& alpha, const ThisType& xx)
@@ -216,7 +231,8 @@ public:
     if (xx.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of x (" << xx.size() << ") does not match the size of this (" << size() << ")!");
-    backend().axpy(alpha, *(xx.backend_));
+    ScalarType* yy = entries();
+    KernelsType::axpy(alpha, xx.entries(), yy, size());
   }
 
   bool has_equal_shape(const ThisType& other) const
@@ -276,22 +292,25 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
+    // the backend defines the semantics for other scalars (e.g. conjugation of complex ones)
+    if (std::is_same< ScalarType, double >::value)
+      return KernelsType::dot(entries(), other.entries(), size());
     return backend_->dot(*(other.backend_));
   } // ... dot(...)
 
   virtual RealType l1_norm() const override final
   {
-    return backend_->one_norm();
+    return KernelsType::l1_norm(entries(), size());
   }
 
   virtual RealType l2_norm() const override final
   {
-    return backend_->two_norm();
+    return KernelsType::l2_norm(entries(), size());
   }
 
   virtual RealType sup_norm() const override final
   {
-    return backend_->infinity_norm();
+    return KernelsType::sup_norm(entries(), size());
   }
 
   virtual void add(const ThisType& other, ThisType& result) const override final
@@ -302,8 +321,8 @@ public:
     if (result.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of result (" << result.size() << ") does not match the size of this (" << size() << ")!");
-    result.backend() = *(backend_);
-    result.backend() += *(other.backend_);
+    ScalarType* result_entries = result.entries();
+    KernelsType::add(entries(), other.entries(), result_entries, size());
   } // ... add(...)
 
   virtual ThisType add(const ThisType& other) const override final
@@ -312,7 +331,7 @@ public:
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
     ThisType result = copy();
-    result.backend_->operator+=(*(other.backend_));
+    result.iadd(other);
     return result;
   } // ... add(...)
 
@@ -321,7 +340,8 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    backend() += *(other.backend_);
+    ScalarType* this_entries = entries();
+    KernelsType::add(this_entries, other.entries(), this_entries, size());
   } // ... iadd(...)
 
   virtual void sub(const ThisType& other, ThisType& result) const override final
@@ -332,8 +352,8 @@ public:
     if (result.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of result (" << result.size() << ") does not match the size of this (" << size() << ")!");
-    result.backend() = *(backend_);
-    result.backend() -= *(other.backend_);
+    ScalarType* result_entries = result.entries();
+    KernelsType::sub(entries(), other.entries(), result_entries, size());
   } // ... sub(...)
 
   virtual ThisType sub(const ThisType& other) const override final
@@ -342,7 +362,7 @@ public:
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
     ThisType result = copy();
-    result.backend_->operator-=(*(other.backend_));
+    result.isub(other);
     return result;
   } // ... sub(...)
 
@@ -351,7 +371,8 @@ public:
     if (other.size() != size())
       DUNE_THROW(Exceptions::shapes_do_not_match,
                  "The size of other (" << other.size() << ") does not match the size of this (" << size() << ")!");
-    backend()-=(*(other.backend_));
+    ScalarType* this_entries = entries();
+    KernelsType::sub(this_entries, other.entries(), this_entries, size());
   } // ... isub(...)
 
   /// \}
@@ -366,6 +387,19 @@ private:
       backend_ = std::make_shared< BackendType >(*backend_);
   } // ... ensure_uniqueness(...)
 
+  //! \return a pointer to the first entry (nullptr if the vector is empty), for the KernelsType
+  const ScalarType* entries() const
+  {
+    return backend_->N() > 0 ? &(backend_->operator[](0)[0]) : nullptr;
+  }
+
+  //! \see entries() const, ensures uniqueness
+  ScalarType* entries()
+  {
+    ensure_uniqueness();
+    return backend_->N() > 0 ? &(backend_->operator[](0)[0]) : nullptr;
+  }
+
   friend class VectorInterface< internal::IstlDenseVectorTraits< ScalarType >, ScalarType >;
   friend class IstlRowMajorSparseMatrix< ScalarType >;
 
@@ -484,7 +518,6 @@ public:
 
   const BackendType& backend() const
   {
-    ensure_uniqueness();
     return *backend_;
   }
 
@@ -0,0 +1,124 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "config.h"
+
+#include <cmath>
+
+#include "kernels.hh"
+
+// the variants only give the same results if no multiply-add is contracted to an fma instruction (which only the AVX
+// variants could do), this file is thus compiled with -ffp-contract=off, see dune/stuff/CMakeLists.txt
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+# if __has_attribute(target_clones)
+#   define DUNE_STUFF_LA_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+# endif
+#endif
+#ifndef DUNE_STUFF_LA_KERNEL
+# define DUNE_STUFF_LA_KERNEL
+#endif
+
+namespace Dune {
+namespace Stuff {
+namespace LA {
+namespace Kernels {
+namespace {
+
+
+const size_t num_accumulators = DUNE_STUFF_LA_KERNEL_ACCUMULATORS;
+static_assert(num_accumulators > 0 && (num_accumulators & (num_accumulators - 1)) == 0,
+              "DUNE_STUFF_LA_KERNEL_ACCUMULATORS has to be a power of two!");
+
+
+/**
+ * The accumulators are updated in blocks of num_accumulators entries, which the compiler turns into one (or several)
+ * vector instructions per block, the remaining entries go to the first accumulators.
+ */
+template< class UpdateType >
+inline void accumulate(double* accumulators, const size_t size, const UpdateType& update)
+{
+  const size_t blocked_size = size - size % num_accumulators;
+  for (size_t ii = 0; ii < blocked_size; ii += num_accumulators)
+    for (size_t kk = 0; kk < num_accumulators; ++kk)
+      update(accumulators[kk], ii + kk);
+  for (size_t ii = blocked_size; ii < size; ++ii)
+    update(accumulators[ii - blocked_size], ii);
+}
+
+inline double pairwise_sum(double* accumulators)
+{
+  for (size_t width = num_accumulators / 2; width > 0; width /= 2)
+    for (size_t kk = 0; kk < width; ++kk)
+      accumulators[kk] += accumulators[kk + width];
+  return accumulators[0];
+}
+
+
+} // namespace
+
+
+DUNE_STUFF_LA_KERNEL double dot(const double* xx, const double* yy, const size_t size)
+{
+  double accumulators[num_accumulators] = {};
+  accumulate(accumulators, size, [&](double& accumulator, const size_t ii) { accumulator += xx[ii] * yy[ii]; });
+  return pairwise_sum(accumulators);
+}
+
+DUNE_STUFF_LA_KERNEL double l1_norm(const double* xx, const size_t size)
+{
+  double accumulators[num_accumulators] = {};
+  accumulate(accumulators, size, [&](double& accumulator, const size_t ii) { accumulator += std::abs(xx[ii]); });
+  return pairwise_sum(accumulators);
+}
+
+DUNE_STUFF_LA_KERNEL double l2_norm(const double* xx, const size_t size)
+{
+  double accumulators[num_accumulators] = {};
+  accumulate(accumulators, size, [&](double& accumulator, const size_t ii) { accumulator += xx[ii] * xx[ii]; });
+  return std::sqrt(pairwise_sum(accumulators));
+}
+
+DUNE_STUFF_LA_KERNEL double sup_norm(const double* xx, const size_t size)
+{
+  double accumulators[num_accumulators] = {};
+  accumulate(accumulators, size, [&](double& accumulator, const size_t ii) {
+    const double value = std::abs(xx[ii]);
+    accumulator = accumulator < value ? value : accumulator;
+  });
+  double ret = 0;
+  for (size_t kk = 0; kk < num_accumulators; ++kk)
+    ret = ret < accumulators[kk] ? accumulators[kk] : ret;
+  return ret;
+} // ... sup_norm(...)
+
+DUNE_STUFF_LA_KERNEL void scal(const double alpha, double* xx, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    xx[ii] *= alpha;
+}
+
+DUNE_STUFF_LA_KERNEL void axpy(const double alpha, const double* xx, double* yy, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    yy[ii] += alpha * xx[ii];
+}
+
+DUNE_STUFF_LA_KERNEL void add(const double* xx, const double* yy, double* result, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    result[ii] = xx[ii] + yy[ii];
+}
+
+DUNE_STUFF_LA_KERNEL void sub(const double* xx, const double* yy, double* result, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    result[ii] = xx[ii] - yy[ii];
+}
+
+
+} // namespace Kernels
+} // namespace LA
+} // namespace Stuff
+} // namespace Dune
@@ -0,0 +1,271 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_LA_CONTAINER_KERNELS_HH
+#define DUNE_STUFF_LA_CONTAINER_KERNELS_HH
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <functional>
+
+#include <dune/common/ftraits.hh>
+
+#include "vector-interface-internal.hh"
+
+namespace Dune {
+namespace Stuff {
+namespace LA {
+namespace Kernels {
+
+
+/**
+ * \brief BLAS level 1 kernels on contiguous arrays of doubles, used by CommonDenseVector and IstlDenseVector.
+ *
+ *        On x86-64 each kernel is compiled for AVX-512, AVX2 and the SSE2 baseline and the variant matching the CPU is
+ *        chosen when the library is loaded (if the compiler supports target_clones, otherwise only the baseline variant
+ *        is built). The arrays do not need to be aligned and may be aliased entrywise, i.e. xx == yy or result == xx
+ *        are fine, partially overlapping arrays are not.
+ *
+ *        Reductions add entry ii to accumulator ii % DUNE_STUFF_LA_KERNEL_ACCUMULATORS and sum up the accumulators
+ *        pairwise at the end. Their results thus only depend on the number of accumulators (which is fixed when
+ *        configuring dune-stuff), not on the chosen variant or the alignment of the arrays.
+ * \{
+ */
+
+double dot(const double* xx, const double* yy, const size_t size);
+
+//! \return sum_ii |xx[ii]|
+double l1_norm(const double* xx, const size_t size);
+
+double l2_norm(const double* xx, const size_t size);
+
+//! \return max_ii |xx[ii]|, 0 if size is 0
+double sup_norm(const double* xx, const size_t size);
+
+//! xx *= alpha
+void scal(const double alpha, double* xx, const size_t size);
+
+//! yy += alpha * xx
+void axpy(const double alpha, const double* xx, double* yy, const size_t size);
+
+//! result = xx + yy
+void add(const double* xx, const double* yy, double* result, const size_t size);
+
+//! result = xx - yy
+void sub(const double* xx, const double* yy, double* result, const size_t size);
+
+/**
+ * \}
+ */
+
+
+} // namespace Kernels
+namespace internal {
+
+
+/**
+ * \brief The BLAS level 1 operations on contiguous arrays, specialized for double to use the Kernels.
+ * \see   ChunkedContiguousKernels
+ */
+template< class ScalarImp >
+struct ContiguousKernels
+{
+  typedef typename Dune::FieldTraits< ScalarImp >::field_type ScalarType;
+  typedef typename Dune::FieldTraits< ScalarImp >::real_type  RealType;
+
+  static ScalarType dot(const ScalarType* xx, const ScalarType* yy, const size_t size)
+  {
+    ScalarType ret(0);
+    for (size_t ii = 0; ii < size; ++ii)
+      ret += xx[ii] * yy[ii];
+    return ret;
+  }
+
+  static RealType l1_norm(const ScalarType* xx, const size_t size)
+  {
+    RealType ret(0);
+    for (size_t ii = 0; ii < size; ++ii)
+      ret += std::abs(xx[ii]);
+    return ret;
+  }
+
+  static RealType squared_l2_norm(const ScalarType* xx, const size_t size)
+  {
+    RealType ret(0);
+    for (size_t ii = 0; ii < size; ++ii)
+      ret += std::norm(xx[ii]);
+    return ret;
+  }
+
+  static RealType sup_norm(const ScalarType* xx, const size_t size)
+  {
+    RealType ret(0);
+    for (size_t ii = 0; ii < size; ++ii)
+      ret = std::max(ret, RealType(std::abs(xx[ii])));
+    return ret;
+  }
+
+  static void scal(const ScalarType& alpha, ScalarType* xx, const size_t size)
+  {
+    for (size_t ii = 0; ii < size; ++ii)
+      xx[ii] *= alpha;
+  }
+
+  static void axpy(const ScalarType& alpha, const ScalarType* xx, ScalarType* yy, const size_t size)
+  {
+    for (size_t ii = 0; ii < size; ++ii)
+      yy[ii] += alpha * xx[ii];
+  }
+
+  static void add(const ScalarType* xx, const ScalarType* yy, ScalarType* result, const size_t size)
+  {
+    for (size_t ii = 0; ii < size; ++ii)
+      result[ii] = xx[ii] + yy[ii];
+  }
+
+  static void sub(const ScalarType* xx, const ScalarType* yy, ScalarType* result, const size_t size)
+  {
+    for (size_t ii = 0; ii < size; ++ii)
+      result[ii] = xx[ii] - yy[ii];
+  }
+}; // struct ContiguousKernels
+
+
+template<>
+struct ContiguousKernels< double >
+{
+  typedef double ScalarType;
+  typedef double RealType;
+
+  static double dot(const double* xx, const double* yy, const size_t size)
+  {
+    return Kernels::dot(xx, yy, size);
+  }
+
+  static double l1_norm(const double* xx, const size_t size)
+  {
+    return Kernels::l1_norm(xx, size);
+  }
+
+  static double squared_l2_norm(const double* xx, const size_t size)
+  {
+    return Kernels::dot(xx, xx, size);
+  }
+
+  static double sup_norm(const double* xx, const size_t size)
+  {
+    return Kernels::sup_norm(xx, size);
+  }
+
+  static void scal(const double& alpha, double* xx, const size_t size)
+  {
+    Kernels::scal(alpha, xx, size);
+  }
+
+  static void axpy(const double& alpha, const double* xx, double* yy, const size_t size)
+  {
+    Kernels::axpy(alpha, xx, yy, size);
+  }
+
+  static void add(const double* xx, const double* yy, double* result, const size_t size)
+  {
+    Kernels::add(xx, yy, result, size);
+  }
+
+  static void sub(const double* xx, const double* yy, double* result, const size_t size)
+  {
+    Kernels::sub(xx, yy, result, size);
+  }
+}; // struct ContiguousKernels< double >
+
+
+/**
+ * \brief The BLAS level 1 operations of vectors with contiguous storage, e.g. CommonDenseVector.
+ *
+ *        The arrays are processed chunkwise by the ContiguousKernels, in parallel for large arrays, see
+ *        reduce_chunks() and for_each_chunk(). The sizes are checked by the caller, the arrays may only be null if
+ *        size is 0.
+ */
+template< class ScalarImp >
+struct ChunkedContiguousKernels
+{
+  typedef ContiguousKernels< ScalarImp >   KernelsType;
+  typedef typename KernelsType::ScalarType ScalarType;
+  typedef typename KernelsType::RealType   RealType;
+
+  static ScalarType dot(const ScalarType* xx, const ScalarType* yy, const size_t size)
+  {
+    return reduce_chunks(size,
+                         [&](const size_t begin, const size_t end) {
+                           return KernelsType::dot(xx + begin, yy + begin, end - begin);
+                         },
+                         std::plus< ScalarType >());
+  } // ... dot(...)
+
+  static RealType l1_norm(const ScalarType* xx, const size_t size)
+  {
+    return reduce_chunks(size,
+                         [&](const size_t begin, const size_t end) {
+                           return KernelsType::l1_norm(xx + begin, end - begin);
+                         },
+                         std::plus< RealType >());
+  } // ... l1_norm(...)
+
+  static RealType l2_norm(const ScalarType* xx, const size_t size)
+  {
+    return std::sqrt(reduce_chunks(size,
+                                   [&](const size_t begin, const size_t end) {
+                                     return KernelsType::squared_l2_norm(xx + begin, end - begin);
+                                   },
+                                   std::plus< RealType >()));
+  } // ... l2_norm(...)
+
+  static RealType sup_norm(const ScalarType* xx, const size_t size)
+  {
+    return reduce_chunks(size,
+                         [&](const size_t begin, const size_t end) {
+                           return KernelsType::sup_norm(xx + begin, end - begin);
+                         },
+                         [](const RealType& left, const RealType& right) { return std::max(left, right); });
+  } // ... sup_norm(...)
+
+  static void scal(const ScalarType& alpha, ScalarType* xx, const size_t size)
+  {
+    for_each_chunk(size, [&](const size_t begin, const size_t end) {
+      KernelsType::scal(alpha, xx + begin, end - begin);
+    });
+  }
+
+  static void axpy(const ScalarType& alpha, const ScalarType* xx, ScalarType* yy, const size_t size)
+  {
+    for_each_chunk(size, [&](const size_t begin, const size_t end) {
+      KernelsType::axpy(alpha, xx + begin, yy + begin, end - begin);
+    });
+  }
+
+  static void add(const ScalarType* xx, const ScalarType* yy, ScalarType* result, const size_t size)
+  {
+    for_each_chunk(size, [&](const size_t begin, const size_t end) {
+      KernelsType::add(xx + begin, yy + begin, result + begin, end - begin);
+    });
+  }
+
+  static void sub(const ScalarType* xx, const ScalarType* yy, ScalarType* result, const size_t size)
+  {
+    for_each_chunk(size, [&](const size_t begin, const size_t end) {
+      KernelsType::sub(xx + begin, yy + begin, result + begin, end - begin);
+    });
+  }
+}; // struct ChunkedContiguousKernels
+
+
+} // namespace internal
+} // namespace LA
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_LA_CONTAINER_KERNELS_HH
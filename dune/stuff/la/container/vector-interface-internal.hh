@@ -8,12 +8,22 @@
 #ifndef DUNE_STUFF_LA_CONTAINER_VECTOR_INTERFACE_INTERNAL_HH
 #define DUNE_STUFF_LA_CONTAINER_VECTOR_INTERFACE_INTERNAL_HH
 
+#include <algorithm>
 #include <iterator>
 #include <type_traits>
+#include <vector>
+
+#if HAVE_TBB
+# include <tbb/blocked_range.h>
+# include <tbb/parallel_for.h>
+#endif
+
+#include <dune/common/unused.hh>
 
 #include <dune/stuff/common/type_utils.hh>
 #include <dune/stuff/common/crtp.hh>
 #include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/parallel/threadmanager.hh>
 
 
 namespace Dune {
@@ -130,6 +140,78 @@ private:
 }; // class VectorOutputIterator
 
 
+/**
+ * \brief The BLAS level 1 operations of the vectors process [0, size) in chunks of this many entries.
+ *
+ *        Reductions are computed chunkwise and the partial results are joined in the order of the chunks, so their
+ *        results depend on this number, but neither on the number of threads nor on whether they run in parallel.
+ */
+static const size_t vector_chunk_size = 16384;
+
+//! \return true if operations on vectors of size entries should use all threads of threadManager()
+inline bool use_parallel_chunks(const size_t DUNE_UNUSED(size))
+{
+#if HAVE_TBB
+  return size >= DUNE_STUFF_LA_PARALLEL_THRESHOLD && size > vector_chunk_size && threadManager().current_threads() > 1;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief Calls functor(begin, end) for all chunks [begin, end) of [0, size), in parallel for large sizes.
+ * \note  For small sizes functor(0, size) is called once.
+ */
+template< class FunctorType >
+void for_each_chunk(const size_t size, const FunctorType& functor)
+{
+#if HAVE_TBB
+  if (use_parallel_chunks(size)) {
+    const size_t num_chunks = (size + vector_chunk_size - 1) / vector_chunk_size;
+    tbb::parallel_for(tbb::blocked_range< size_t >(0, num_chunks), [&](const tbb::blocked_range< size_t >& range) {
+      for (size_t cc = range.begin(); cc != range.end(); ++cc)
+        functor(cc * vector_chunk_size, std::min(size, (cc + 1) * vector_chunk_size));
+    });
+    return;
+  }
+#endif // HAVE_TBB
+  functor(0, size);
+} // ... for_each_chunk(...)
+
+/**
+ * \brief Reduces [0, size) chunkwise, in parallel for large sizes.
+ *
+ *        Computes functor(begin, end) for all chunks [begin, end) of [0, size) and joins the partial results from left
+ *        to right, i.e. returns join(join(functor(chunk_0), functor(chunk_1)), ...), or functor(0, 0) if size is 0.
+ */
+template< class FunctorType, class JoinType >
+auto reduce_chunks(const size_t size, const FunctorType& functor, const JoinType& join)
+    -> decltype(functor(size_t(0), size_t(0)))
+{
+  typedef decltype(functor(size_t(0), size_t(0))) ResultType;
+  const size_t num_chunks = (size + vector_chunk_size - 1) / vector_chunk_size;
+  if (num_chunks <= 1)
+    return functor(0, size);
+#if HAVE_TBB
+  if (use_parallel_chunks(size)) {
+    std::vector< ResultType > partial_results(num_chunks);
+    tbb::parallel_for(tbb::blocked_range< size_t >(0, num_chunks), [&](const tbb::blocked_range< size_t >& range) {
+      for (size_t cc = range.begin(); cc != range.end(); ++cc)
+        partial_results[cc] = functor(cc * vector_chunk_size, std::min(size, (cc + 1) * vector_chunk_size));
+    });
+    ResultType ret = partial_results[0];
+    for (size_t cc = 1; cc < num_chunks; ++cc)
+      ret = join(ret, partial_results[cc]);
+    return ret;
+  }
+#endif // HAVE_TBB
+  ResultType ret = functor(0, vector_chunk_size);
+  for (size_t cc = 1; cc < num_chunks; ++cc)
+    ret = join(ret, functor(cc * vector_chunk_size, std::min(size, (cc + 1) * vector_chunk_size)));
+  return ret;
+} // ... reduce_chunks(...)
+
+
 } // namespace internal
 } // namespace LA
 } // namespace Stuff
@@ -9,6 +9,7 @@
 #define DUNE_STUFF_LA_CONTAINER_VECTOR_INTERFACE_HH
 
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <iostream>
 #include <vector>
@@ -39,11 +40,267 @@ namespace Tags {
 
 
 class VectorInterface {};
+class VectorExpression {};
 
 
 } // namespace Tags
 
 
+/**
+ *  \brief Base class of all lazy vector expressions, which are created by the arithmetic operators below.
+ *
+ *         An expression only holds references to the vectors involved and is evaluated componentwise in a single loop
+ *         once it is assigned to a vector, e.g.
+\code
+VectorType u = ...;
+u.assign(u_0 + dt*(k_1 + k_2) - v);
+u += dt*k_3;
+VectorType w = u - v;
+\endcode
+ *         involves no temporary vectors and only one pass over the memory of each vector per line.
+ *  \note  Since only references are held, an expression must not outlive the vectors it was created from, so better
+ *         do not store expressions using auto.
+ */
+template< class ExpressionImp, class VectorImp >
+class VectorExpression
+  : public Tags::VectorExpression
+{
+public:
+  typedef ExpressionImp                  derived_type;
+  typedef VectorImp                      VectorType;
+  typedef typename VectorImp::ScalarType ScalarType;
+
+  inline const derived_type& as_imp() const
+  {
+    return static_cast< const derived_type& >(*this);
+  }
+
+  inline size_t size() const
+  {
+    return as_imp().size();
+  }
+
+  inline ScalarType operator[](const size_t ii) const
+  {
+    return as_imp()[ii];
+  }
+
+  //! evaluates this expression into a new vector
+  operator VectorType() const
+  {
+    VectorType ret(size());
+    ret.assign(*this);
+    return ret;
+  }
+}; // class VectorExpression
+
+
+namespace internal {
+
+
+template< class VectorImp >
+class VectorExpressionLeaf
+  : public VectorExpression< VectorExpressionLeaf< VectorImp >, VectorImp >
+{
+public:
+  typedef typename VectorImp::ScalarType ScalarType;
+
+  explicit VectorExpressionLeaf(const VectorImp& vector)
+    : vector_(vector)
+  {}
+
+  inline size_t size() const
+  {
+    return vector_.size();
+  }
+
+  inline ScalarType operator[](const size_t ii) const
+  {
+    return vector_.get_entry(ii);
+  }
+
+private:
+  const VectorImp& vector_;
+}; // class VectorExpressionLeaf
+
+
+struct VectorExpressionPlus
+{
+  template< class S >
+  static inline S apply(const S& left, const S& right)
+  {
+    return left + right;
+  }
+};
+
+
+struct VectorExpressionMinus
+{
+  template< class S >
+  static inline S apply(const S& left, const S& right)
+  {
+    return left - right;
+  }
+};
+
+
+template< class L, class R, class Operation >
+class VectorBinaryExpression
+  : public VectorExpression< VectorBinaryExpression< L, R, Operation >, typename L::VectorType >
+{
+  static_assert(std::is_same< typename L::VectorType, typename R::VectorType >::value,
+                "Expressions of different vector types can not be combined!");
+public:
+  typedef typename L::ScalarType ScalarType;
+
+  VectorBinaryExpression(const L& left, const R& right)
+    : left_(left)
+    , right_(right)
+  {
+    if (right_.size() != left_.size())
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "The size of the right operand (" << right_.size() << ") does not match the size of the left one ("
+                 << left_.size() << ")!");
+  }
+
+  inline size_t size() const
+  {
+    return left_.size();
+  }
+
+  inline ScalarType operator[](const size_t ii) const
+  {
+    return Operation::apply(left_[ii], right_[ii]);
+  }
+
+private:
+  const L left_;
+  const R right_;
+}; // class VectorBinaryExpression
+
+
+template< class E >
+class VectorScaledExpression
+  : public VectorExpression< VectorScaledExpression< E >, typename E::VectorType >
+{
+public:
+  typedef typename E::ScalarType ScalarType;
+
+  VectorScaledExpression(const ScalarType& alpha, const E& expression)
+    : alpha_(alpha)
+    , expression_(expression)
+  {}
+
+  inline size_t size() const
+  {
+    return expression_.size();
+  }
+
+  inline ScalarType operator[](const size_t ii) const
+  {
+    return alpha_*expression_[ii];
+  }
+
+private:
+  const ScalarType alpha_;
+  const E expression_;
+}; // class VectorScaledExpression
+
+
+/**
+ * \brief Maps vectors to VectorExpressionLeaf and keeps expressions, has no type for anything else.
+ */
+template< class T,
+          bool is_vector = std::is_base_of< Tags::VectorInterface, T >::value,
+          bool is_expression = std::is_base_of< Tags::VectorExpression, T >::value >
+struct VectorExpressionOperand
+{};
+
+
+template< class Traits, class S >
+typename Traits::derived_type vector_derived_type(const VectorInterface< Traits, S >&);
+
+
+template< class T >
+struct VectorExpressionOperand< T, true, false >
+{
+  //! derived_type is ambiguous in most vectors, since they have more than one crtp base
+  typedef decltype(vector_derived_type(std::declval< T >())) VectorType;
+  typedef VectorExpressionLeaf< VectorType >                  type;
+
+  static type make(const T& vector)
+  {
+    return type(static_cast< const VectorType& >(vector));
+  }
+}; // struct VectorExpressionOperand< ..., true, false >
+
+
+template< class T >
+struct VectorExpressionOperand< T, false, true >
+{
+  typedef typename T::derived_type type;
+
+  static const type& make(const T& expression)
+  {
+    return expression.as_imp();
+  }
+}; // struct VectorExpressionOperand< ..., false, true >
+
+
+} // namespace internal
+
+
+/**
+ * \name Arithmetic operators for vectors and vector expressions.
+ * \see  VectorExpression
+ * \{
+ */
+
+template< class L, class R >
+internal::VectorBinaryExpression< typename internal::VectorExpressionOperand< L >::type,
+                                  typename internal::VectorExpressionOperand< R >::type,
+                                  internal::VectorExpressionPlus >
+operator+(const L& left, const R& right)
+{
+  return { internal::VectorExpressionOperand< L >::make(left), internal::VectorExpressionOperand< R >::make(right) };
+}
+
+template< class L, class R >
+internal::VectorBinaryExpression< typename internal::VectorExpressionOperand< L >::type,
+                                  typename internal::VectorExpressionOperand< R >::type,
+                                  internal::VectorExpressionMinus >
+operator-(const L& left, const R& right)
+{
+  return { internal::VectorExpressionOperand< L >::make(left), internal::VectorExpressionOperand< R >::make(right) };
+}
+
+template< class E >
+internal::VectorScaledExpression< typename internal::VectorExpressionOperand< E >::type >
+operator*(const typename internal::VectorExpressionOperand< E >::type::ScalarType& alpha, const E& expression)
+{
+  return { alpha, internal::VectorExpressionOperand< E >::make(expression) };
+}
+
+template< class E >
+internal::VectorScaledExpression< typename internal::VectorExpressionOperand< E >::type >
+operator*(const E& expression, const typename internal::VectorExpressionOperand< E >::type::ScalarType& alpha)
+{
+  return { alpha, internal::VectorExpressionOperand< E >::make(expression) };
+}
+
+template< class E >
+internal::VectorScaledExpression< typename internal::VectorExpressionOperand< E >::type >
+operator-(const E& expression)
+{
+  typedef typename internal::VectorExpressionOperand< E >::type::ScalarType ScalarType;
+  return { ScalarType(-1), internal::VectorExpressionOperand< E >::make(expression) };
+}
+
+/**
+ * \}
+ */
+
+
 template< class Traits, class ScalarImp = typename Traits::ScalarType >
 class VectorInterface
   : public ContainerInterface< Traits, ScalarImp >
@@ -57,6 +314,10 @@ public:
   typedef internal::VectorInputIterator< Traits, ScalarType >  const_iterator;
   typedef internal::VectorOutputIterator< Traits, ScalarType > iterator;
 
+private:
+  typedef internal::VectorExpressionLeaf< derived_type > LeafType;
+
+public:
   virtual ~VectorInterface() {}
 
   /// \name Have to be implemented by a derived class in addition to the ones required by ContainerInterface!
@@ -113,6 +374,8 @@ public:
   /// \}
   /// \name Provided by the interface for convenience!
   /// \note Those marked as virtual may be implemented more efficiently in a derived class!
+  /// \note mean(), amax() and standard_deviation() read large vectors from several threads (see
+  ///       internal::reduce_chunks()), get_entry_ref() const thus must not modify the vector.
   /// \{
 
   virtual void set_all(const ScalarType& val)
@@ -158,9 +421,15 @@ public:
 
   virtual ScalarType mean() const
   {
-    ScalarType ret = 0.0;
-    for (const auto& element : *this)
-      ret += element;
+    const derived_type& self = this->as_imp();
+    ScalarType ret = internal::reduce_chunks(size(),
+                                             [&](const size_t begin, const size_t end) {
+                                               ScalarType sum = 0.0;
+                                               for (size_t ii = begin; ii < end; ++ii)
+                                                 sum += self.get_entry_ref(ii);
+                                               return sum;
+                                             },
+                                             std::plus< ScalarType >());
     ret /= size();
     return ret;
   } // ... mean()
@@ -172,15 +441,23 @@ public:
    */
   virtual std::pair< size_t, RealType > amax() const
   {
-    auto result = std::make_pair(size_t(0), RealType(0));
-    for (size_t ii = 0; ii < size(); ++ii) {
-      const auto value = std::abs(get_entry_ref(ii));
-      if (value > result.second) {
-        result.first = ii;
-        result.second = value;
-      }
-    }
-    return result;
+    const derived_type& self = this->as_imp();
+    return internal::reduce_chunks(size(),
+                                   [&](const size_t begin, const size_t end) {
+                                     auto result = std::make_pair(begin, RealType(0));
+                                     for (size_t ii = begin; ii < end; ++ii) {
+                                       const auto value = std::abs(self.get_entry_ref(ii));
+                                       if (value > result.second) {
+                                         result.first = ii;
+                                         result.second = value;
+                                       }
+                                     }
+                                     return result;
+                                   },
+                                   [](const std::pair< size_t, RealType >& left,
+                                      const std::pair< size_t, RealType >& right) {
+                                     return right.second > left.second ? right : left;
+                                   });
   } // ... amax(...)
 
   /**
@@ -276,9 +553,15 @@ public:
   virtual ScalarType standard_deviation() const
   {
     const ScalarType mu = mean();
-    ScalarType sigma = 0.0;
-    for (const auto& x_i : *this)
-      sigma += std::pow(x_i - mu, 2);
+    const derived_type& self = this->as_imp();
+    ScalarType sigma = internal::reduce_chunks(size(),
+                                               [&](const size_t begin, const size_t end) {
+                                                 ScalarType sum = 0.0;
+                                                 for (size_t ii = begin; ii < end; ++ii)
+                                                   sum += std::pow(self.get_entry_ref(ii) - mu, 2);
+                                                 return sum;
+                                               },
+                                               std::plus< ScalarType >());
     sigma /= size();
     return std::sqrt(sigma);
   } // ... standard_deviation(...)
@@ -381,18 +664,6 @@ public:
       set_entry(ii, get_entry_ref(ii) - other.get_entry_ref(ii));
   } // ... isub(...)
 
-  /**
-   *  \brief  Multiplies every component of this by a scalar.
-   *  \param  alpha The scalar.
-   *  \return The scaled copy of this.
-   */
-  virtual derived_type operator*(const ScalarType& alpha)
-  {
-    derived_type ret = this->copy();
-    ret *= alpha;
-    return ret;
-  } // ... operator*() ...
-
   /**
    *  \brief  Computes the scalar products between this and another vector.
    *  \param  other The second factor.
@@ -427,25 +698,80 @@ public:
   }
 
   /**
-   *  \brief  Adds two vectors.
-   *  \param  other The second summand.
-   *  \return The sum of the two vectors.
+   *  \brief  Evaluates a vector expression and writes the result to this.
+   *  \param  expression The expression, e.g. a + alpha*b - c.
+   *  \return This.
+   *  \note   The expression is evaluated in a single loop, without temporaries. Since the expression is evaluated
+   *          componentwise, this may appear in the expression.
+   *  \see    VectorExpression
+   */
+  template< class E >
+  derived_type& assign(const VectorExpression< E, derived_type >& expression)
+  {
+    evaluate(expression, [](ScalarType& target, const ScalarType& value) { target = value; });
+    return this->as_imp(*this);
+  }
+
+  /**
+   *  \brief  Adds a vector expression to this, in-place variant.
+   *  \param  expression The second summand.
+   *  \return The sum of this and expression.
+   *  \see    assign()
+   */
+  template< class E >
+  derived_type& operator+=(const VectorExpression< E, derived_type >& expression)
+  {
+    evaluate(expression, [](ScalarType& target, const ScalarType& value) { target += value; });
+    return this->as_imp(*this);
+  }
+
+  /**
+   *  \brief  Subtracts a vector expression from this, in-place variant.
+   *  \param  expression The subtrahend.
+   *  \return The difference between this and expression.
+   *  \see    assign()
    */
-  virtual derived_type operator+(const derived_type& other) const
+  template< class E >
+  derived_type& operator-=(const VectorExpression< E, derived_type >& expression)
   {
-    return add(other);
+    evaluate(expression, [](ScalarType& target, const ScalarType& value) { target -= value; });
+    return this->as_imp(*this);
   }
 
   /**
-   *  \brief  Substracts two vectors.
-   *  \param  other The subtrahend
-   *  \return The difference.
+   * \name Arithmetic operators for two vectors of the same type.
+   * \note These are more specific than the operators for arbitrary vector expressions above and than those from
+   *       dune/stuff/common/vector.hh and are thus preferred.
+   * \see  VectorExpression
+   * \{
    */
-  virtual derived_type operator-(const derived_type& other) const
+
+  friend internal::VectorBinaryExpression< LeafType, LeafType, internal::VectorExpressionPlus >
+  operator+(const derived_type& left, const derived_type& right)
+  {
+    return { LeafType(left), LeafType(right) };
+  }
+
+  friend internal::VectorBinaryExpression< LeafType, LeafType, internal::VectorExpressionMinus >
+  operator-(const derived_type& left, const derived_type& right)
+  {
+    return { LeafType(left), LeafType(right) };
+  }
+
+  friend internal::VectorScaledExpression< LeafType > operator*(const ScalarType& alpha, const derived_type& vector)
+  {
+    return { alpha, LeafType(vector) };
+  }
+
+  friend internal::VectorScaledExpression< LeafType > operator*(const derived_type& vector, const ScalarType& alpha)
   {
-    return sub(other);
+    return { alpha, LeafType(vector) };
   }
 
+  /**
+   * \}
+   */
+
   virtual derived_type& operator+=(const ScalarType& scalar)
   {
     for (auto& element : *this)
@@ -621,6 +947,37 @@ public:
   }
 
 private:
+  template< class E, class AssignmentType >
+  void evaluate(const VectorExpression< E, derived_type >& expression, const AssignmentType& assignment)
+  {
+    if (expression.size() != size())
+      DUNE_THROW(Exceptions::shapes_do_not_match,
+                 "The size of expression (" << expression.size() << ") does not match the size of this (" << size()
+                 << ")!");
+    evaluate(expression.as_imp(), assignment, std::is_base_of< Tags::ProvidesDataAccess, derived_type >());
+  } // ... evaluate(...)
+
+  //! uniqueness is ensured only once by data(), the loop works on the raw array
+  template< class E, class AssignmentType >
+  void evaluate(const E& expression, const AssignmentType& assignment, std::true_type)
+  {
+    const size_t sz = size();
+    if (sz == 0)
+      return;
+    ScalarType* values = this->as_imp().data();
+    for (size_t ii = 0; ii < sz; ++ii)
+      assignment(values[ii], expression[ii]);
+  } // ... evaluate(...)
+
+  template< class E, class AssignmentType >
+  void evaluate(const E& expression, const AssignmentType& assignment, std::false_type)
+  {
+    auto& vector = this->as_imp();
+    const size_t sz = size();
+    for (size_t ii = 0; ii < sz; ++ii)
+      assignment(vector.get_entry_ref(ii), expression[ii]);
+  } // ... evaluate(...)
+
   template< class T, class S >
   friend std::ostream& operator<<(std::ostream& /*out*/, const VectorInterface< T, S >& /*vector*/);
 }; // class VectorInterface
@@ -692,7 +1049,6 @@ struct VectorAbstractionBase
 } // namespace internal
 
 
-
 template< class T, class S >
 std::ostream& operator<<(std::ostream& out, const VectorInterface< T, S >& vector)
 {
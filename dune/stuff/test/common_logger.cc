@@ -8,6 +8,11 @@
 // dune-stuff
 #include <dune/stuff/common/logging.hh>
 #include <dune/stuff/common/logstreams.hh>
+#include <dune/stuff/common/binarylogging.hh>
+
+#include <thread>
+#include <sstream>
+#include <fstream>
 
 namespace DSC = Dune::Stuff::Common;
 
@@ -62,3 +67,53 @@ TEST(LoggerTest, file) {
   DSC::Logger().create(DSC::LOG_INFO | DSC::LOG_CONSOLE | DSC::LOG_FILE, "test_common_logger", "", "");
   DSC::Logger().info() << "This output should be in 'test_common_logger.log'" << std::endl;
 }
+
+TEST(LoggerTest, async) {
+  auto& sink = DSC::AsyncLogSink();
+  sink.enable(64);
+  std::stringstream output;
+  Dune::Timer timer;
+  const size_t num_threads = 4;
+  const size_t num_lines = 1000;
+  std::vector< std::thread > threads;
+  for (size_t tt = 0; tt < num_threads; ++tt)
+    threads.emplace_back([&]() {
+      DSC::TimedPrefixedLogStream out(timer, "async: ", output);
+      for (size_t ii = 0; ii < num_lines; ++ii)
+        out << "line " << ii << std::endl;
+    });
+  for (auto& thread : threads)
+    thread.join();
+  sink.flush();
+  size_t written = 0;
+  std::string line;
+  while (std::getline(output, line))
+    ++written;
+  // lines are either written or dropped, but never lost
+  EXPECT_EQ(num_threads * num_lines, written + sink.dropped());
+  sink.disable();
+  EXPECT_FALSE(sink.enabled());
+}
+
+TEST(LoggerTest, binary) {
+  auto& logger = DSC::BinaryLogger();
+  logger.create("test_common_logger.blog");
+  DSC_BINARY_LOG_INFO("binary", "int %d, double %e and %s", -1, 0.5, std::string("string"));
+  DSC_BINARY_LOG_DEBUG("binary", "two\nlines");
+  DSC_BINARY_LOG_WARN("", "empty id");
+  logger.close();
+  DSC_BINARY_LOG_INFO("binary", "this should not be logged");
+  std::ifstream in("test_common_logger.blog", std::ios::binary);
+  std::stringstream decoded;
+  DSC::BinaryLogging::decode(in, decoded);
+  std::string line;
+  std::getline(decoded, line);
+  EXPECT_EQ("00:00|binary[info]: int -1, double 5.000000e-01 and string", line);
+  std::getline(decoded, line);
+  EXPECT_EQ("00:00|binary[debug]: two", line);
+  std::getline(decoded, line);
+  EXPECT_EQ("00:00|binary[debug]: lines", line);
+  std::getline(decoded, line);
+  EXPECT_EQ("00:00|warn: empty id", line);
+  EXPECT_FALSE(std::getline(decoded, line));
+}
@@ -10,6 +10,9 @@
 #include <array>
 #include <initializer_list>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 #include <dune/stuff/common/parallel/threadmanager.hh>
 #include <dune/stuff/common/parallel/threadstorage.hh>
 #include <dune/stuff/common/parallel/helper.hh>
@@ -24,6 +27,15 @@ void value_check(ThreadValue& foo, const typename ThreadValue::ValueType& value)
   EXPECT_EQ(*(foo.operator->()), value);
 }
 
+template <typename ThreadValue>
+void combine_check(const ThreadValue& foo) {
+  long total = 0;
+  size_t count = 0;
+  foo.combine_each([&](const typename ThreadValue::ValueType& v){ total += v; ++count; });
+  EXPECT_GT(count, 0);
+  EXPECT_EQ(total, foo.sum());
+}
+
 template< typename ThreadValue, bool = std::is_const<typename ThreadValue::ValueType>::value
           || std::is_const<ThreadValue>::value>
 struct Checker {
@@ -31,6 +43,7 @@ struct Checker {
     auto& const_foo = static_cast<const ThreadValue&>(foo);
     value_check(const_foo, value);
     EXPECT_GT(const_foo.sum(), 0);
+    combine_check(const_foo);
   }
 };
 
@@ -40,6 +53,7 @@ struct Checker<ThreadValue, false /*valuetype is not const*/> {
     auto& const_foo = static_cast<const ThreadValue&>(foo);
     value_check(const_foo, value);
     EXPECT_GT(const_foo.sum(), 0);
+    combine_check(const_foo);
 
     const auto new_value = typename ThreadValue::ValueType(9);
     typename ThreadValue::ValueType& bar = *foo;
@@ -79,5 +93,87 @@ TYPED_TEST(ThreadValueTest, All) {
 }
 
 TEST(ThreadManagerTBB, All) {
+  auto& manager = threadManager();
+  const auto thread = manager.thread();
+  EXPECT_EQ(thread, manager.thread());
+  EXPECT_LT(thread, manager.max_threads());
+  EXPECT_EQ(manager.max_threads(), manager.current_threads());
+  EXPECT_GE(manager.numa_nodes(), size_t(1));
+
+  const auto affinity = manager.affinity();
+  for (auto placement : {ThreadManager::Affinity::compact, ThreadManager::Affinity::scatter, affinity}) {
+    manager.set_affinity(placement);
+    EXPECT_EQ(placement, manager.affinity());
+  }
+}
+
+#if HAVE_TBB
+//! thread() of count concurrently alive threads
+std::vector<size_t> concurrent_thread_indices(const size_t count) {
+  std::vector<size_t> indices(count);
+  std::atomic<size_t> arrived(0);
+  std::vector<std::thread> threads;
+  for (size_t ii = 0; ii < count; ++ii)
+    threads.emplace_back([&, ii] {
+      indices[ii] = threadManager().thread();
+      ++arrived;
+      while (arrived < count)
+        std::this_thread::yield();
+    });
+  for (auto& thread : threads)
+    thread.join();
+  return indices;
+}
+
+TEST(ThreadManagerTBB, Slots) {
+  auto& manager = threadManager();
+  const auto max_threads = manager.max_threads();
+  const auto main_index = manager.thread();
+  const size_t large = 8;
+  const size_t small = 2;
+  const auto check_slots = [&](std::vector<size_t> indices, const size_t slots) {
+    indices.push_back(main_index);
+    std::sort(indices.begin(), indices.end());
+    EXPECT_TRUE(std::adjacent_find(indices.begin(), indices.end()) == indices.end());
+    for (const auto index : indices)
+      EXPECT_LT(index, slots);
+  };
+  manager.set_max_threads(large);
+  check_slots(concurrent_thread_indices(large - 1), large);
+
+  // a thread holding a large index moves to the smallest free one once the pool is shrunk
+  std::atomic<size_t> arrived(0);
+  std::atomic<bool> shrunk(false);
+  size_t before = 0;
+  size_t after = 0;
+  std::vector<std::thread> others;
+  for (size_t ii = 0; ii < large - 2; ++ii)
+    others.emplace_back([&] {
+      threadManager().thread();
+      ++arrived;
+      while (arrived < large - 1)
+        std::this_thread::yield();
+    });
+  std::thread survivor([&] {
+    while (arrived < large - 2)
+      std::this_thread::yield();
+    before = threadManager().thread();
+    ++arrived;
+    while (!shrunk)
+      std::this_thread::yield();
+    after = threadManager().thread();
+  });
+  for (auto& thread : others)
+    thread.join();
+  manager.set_max_threads(small);
+  shrunk = true;
+  survivor.join();
+  EXPECT_GE(before, small);
+  EXPECT_LT(after, small);
+  EXPECT_NE(after, main_index);
 
+  manager.set_max_threads(large);
+  check_slots(concurrent_thread_indices(large - 1), large);
+  manager.set_max_threads(max_threads);
 }
+#endif // HAVE_TBB
@@ -0,0 +1,42 @@
+// This file is part of the dune-stuff project:
+//   https://github.com/wwu-numerik/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "main.hxx"
+
+#include <atomic>
+#include <string>
+
+#if HAVE_TBB
+# include <tbb/parallel_for.h>
+#endif
+
+#include <dune/stuff/common/configuration.hh>
+#include <dune/stuff/common/parallel/threadmanager.hh>
+
+using namespace Dune::Stuff;
+
+// main() constructs threadManager() before any test runs, so the affinity has to be configured before main
+static const bool affinity_configured = [] {
+  DSC_CONFIG.set("threading.affinity", "compact");
+  return true;
+}();
+
+TEST(ThreadManagerAffinity, Construction) {
+  EXPECT_TRUE(affinity_configured);
+  auto& manager = threadManager();
+  EXPECT_EQ(ThreadManager::Affinity::compact, manager.affinity());
+  EXPECT_LT(manager.thread(), manager.max_threads());
+#if HAVE_TBB
+  // every worker entering the scheduler is pinned by the observer created during construction
+  std::atomic<size_t> count(0);
+  tbb::parallel_for(size_t(0), size_t(1000), [&](const size_t) {
+    manager.thread();
+    ++count;
+  });
+  EXPECT_EQ(size_t(1000), count.load());
+#endif
+  manager.set_affinity(ThreadManager::Affinity::none);
+  EXPECT_EQ(ThreadManager::Affinity::none, manager.affinity());
+}
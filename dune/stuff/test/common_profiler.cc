@@ -9,6 +9,13 @@
 #include <dune/stuff/common/math.hh>
 #include <dune/stuff/common/ranges.hh>
 
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <future>
+#include <thread>
+
 using namespace Dune::Stuff::Common;
 const size_t wait_ms = 142;
 
@@ -36,6 +43,15 @@ TEST(ProfilerTest, ScopedTiming) {
   EXPECT_GE(DSC_PROFILER.getTiming("ProfilerTest.ScopedTiming"), long(dvalueRange.size() * wait_ms));
 }
 
+TEST(ProfilerTest, TimingsAll) {
+  scoped_busywait("ProfilerTest.TimingsAll", 1);
+  std::stringstream all;
+  DSC_PROFILER.outputTimingsAll(all);
+  EXPECT_NE(all.str().find("ProfilerTest.TimingsAll_avg_per_thread"), std::string::npos);
+  EXPECT_NE(all.str().find("ProfilerTest.TimingsAll_max_wall"), std::string::npos);
+  EXPECT_EQ(all.str().find("_usr"), std::string::npos);
+}
+
 TEST(ProfilerTest, OutputConstness) {
   DSC_PROFILER.reset(1);
   const auto& prof = DSC_PROFILER;
@@ -61,3 +77,170 @@ TEST(ProfilerTest, NestedTiming) {
   EXPECT_GT(outer, inner);
 }
 
+
+TEST(ProfilerTest, RunningOnOtherThread) {
+  auto& prof = DSC_PROFILER;
+  const auto section = prof.registerSection("ProfilerTest.RunningOnOtherThread");
+  std::promise<void> started, stop;
+  auto stopped = stop.get_future();
+  std::thread worker([&]() {
+    prof.startTiming(section);
+    started.set_value();
+    stopped.wait();
+    prof.stopTiming(section);
+  });
+  started.get_future().wait();
+  EXPECT_THROW(prof.getTiming("ProfilerTest.RunningOnOtherThread"), Dune::InvalidStateException);
+  EXPECT_THROW(prof.nextRun(), Dune::InvalidStateException);
+  stop.set_value();
+  worker.join();
+  EXPECT_NO_THROW(prof.getTiming("ProfilerTest.RunningOnOtherThread"));
+}
+
+TEST(ProfilerTest, SectionHandles) {
+  auto& prof = DSC_PROFILER;
+  prof.reset(1);
+  const auto section = prof.registerSection("SectionHandles");
+  EXPECT_EQ(section, prof.registerSection("SectionHandles"));
+  EXPECT_NE(section, prof.registerSection("SectionHandles.Other"));
+  EXPECT_EQ("SectionHandles", prof.sectionName(section));
+  for (auto DUNE_UNUSED(i) : valueRange(2)) {
+    ScopedTiming DUNE_UNUSED(timing)(section);
+    busywait(wait_ms);
+  }
+  EXPECT_GE(prof.getTiming("SectionHandles"), long(2 * wait_ms * confidence_margin()));
+  EXPECT_GE(prof.getTiming("SectionHandles", true), long(2 * wait_ms * confidence_margin()));
+}
+
+TEST(ProfilerTest, CallTree) {
+  auto& prof = DSC_PROFILER;
+  prof.reset(1);
+  {
+    ScopedTiming DUNE_UNUSED(outer)("CallTree.Outer");
+    busywait(10);
+    for (auto DUNE_UNUSED(i) : valueRange(2)) {
+      ScopedTiming DUNE_UNUSED(inner)("CallTree.Inner");
+      busywait(10);
+    }
+  }
+  std::stringstream collapsed;
+  prof.outputCallTreeCollapsed(collapsed);
+  EXPECT_NE(collapsed.str().find("CallTree.Outer;CallTree.Inner "), std::string::npos);
+  std::stringstream json;
+  prof.outputCallTreeJson(json);
+  EXPECT_NE(json.str().find("\"name\": \"CallTree.Inner\", \"calls\": 2"), std::string::npos);
+  prof.outputCallTree("calltree");
+}
+
+TEST(ProfilerTest, Tracing) {
+  auto& prof = DSC_PROFILER;
+  prof.setOutputdir("profiling_trace");
+  prof.enableTracing("profiler_test_trace.json", 16);
+  for (auto DUNE_UNUSED(i) : valueRange(2))
+    scoped_busywait("Tracing.Section", 10);
+  prof.disableTracing();
+  std::ifstream file("profiling_trace/profiler_test_trace.json");
+  std::stringstream written;
+  written << file.rdbuf();
+  EXPECT_NE(written.str().find("Tracing.Section"), std::string::npos);
+  scoped_busywait("Tracing.Untraced", 10);
+  std::stringstream trace;
+  prof.outputTrace(trace);
+  EXPECT_NE(trace.str().find("{\"name\": \"Tracing.Section\", \"ph\": \"X\""), std::string::npos);
+  EXPECT_EQ(trace.str().find("Tracing.Untraced"), std::string::npos);
+}
+
+TEST(ProfilerTest, Counters) {
+  auto& prof = DSC_PROFILER;
+  prof.reset(1);
+  // the counters may not be permitted (or not be supported at all), the profiler has to work anyway
+  const bool available = prof.enableCounters();
+  scoped_busywait("Counters.Section", 10);
+  prof.disableCounters();
+  std::stringstream timings;
+  prof.outputTimings(timings);
+  EXPECT_NE(timings.str().find("Counters.Section"), std::string::npos);
+  if (available)
+    EXPECT_NE(timings.str().find("Counters.Section_ipc"), std::string::npos);
+  else
+    EXPECT_EQ(timings.str().find("_ipc"), std::string::npos);
+}
+
+TEST(ProfilerTest, ColumnsOfRuns) {
+  auto& prof = DSC_PROFILER;
+  prof.reset(2);
+  // counters and sections of the first run only
+  prof.enableCounters();
+  scoped_busywait("Columns.First", 1);
+  prof.disableCounters();
+  prof.nextRun();
+  scoped_busywait("Columns.Second", 1);
+  std::stringstream timings;
+  prof.outputTimings(timings);
+  std::string line;
+  std::vector<long> columns;
+  while (std::getline(timings, line))
+    if (!line.empty())
+      columns.push_back(std::count(line.begin(), line.end(), ','));
+  ASSERT_EQ(columns.size(), size_t(3));
+  EXPECT_EQ(columns[0], columns[1]);
+  EXPECT_EQ(columns[0], columns[2]);
+  prof.reset(1);
+}
+
+TEST(ProfilerTest, RunStatistics) {
+  auto& prof = DSC_PROFILER;
+  const size_t runs = 4;
+  prof.reset(runs);
+  prof.setWarmupRuns(1);
+  prof.setOutputdir("profiling_statistics");
+  for (auto DUNE_UNUSED(run) : valueRange(runs)) {
+    scoped_busywait("Statistics.Section", 10);
+    prof.nextRun();
+  }
+  prof.outputAveraged(0, 0);
+  prof.setWarmupRuns(0);
+  std::ifstream csv("profiling_statistics/p1_refinelvl_0.csv");
+  std::string header;
+  std::getline(csv, header);
+  EXPECT_NE(header.find("warmup runs"), std::string::npos);
+  for (const auto column : {"_min", "_median", "_p95", "_max", "_stddev", "_outliers"})
+    EXPECT_NE(header.find(std::string("Statistics.Section") + column), std::string::npos);
+}
+
+TEST(ProfilerTest, Metrics) {
+  auto& prof = DSC_PROFILER;
+  prof.setOutputdir("profiling_metrics");
+  prof.enableMetrics("metrics.prom", Profiler::MetricsFormat::prometheus, std::chrono::milliseconds(10));
+  scoped_busywait("Metrics.Section", 20);
+  prof.addCount(42);
+  prof.disableMetrics();
+  std::ifstream file("profiling_metrics/metrics.prom");
+  std::stringstream metrics;
+  metrics << file.rdbuf();
+  EXPECT_NE(metrics.str().find("dune_stuff_section_calls_total{rank=\"0\",section=\"Metrics.Section\"} 1"),
+            std::string::npos);
+  EXPECT_NE(metrics.str().find("dune_stuff_count_total{rank=\"0\",id=\"42\"} 1"), std::string::npos);
+  EXPECT_NE(metrics.str().find("dune_stuff_thread_utilization"), std::string::npos);
+  std::stringstream json;
+  prof.outputMetrics(json, Profiler::MetricsFormat::json);
+  EXPECT_NE(json.str().find("{\"name\": \"Metrics.Section\""), std::string::npos);
+}
+
+TEST(ProfilerTest, Allocations) {
+  auto& prof = DSC_PROFILER;
+  prof.reset(1);
+  const bool available = prof.enableAllocationTracking();
+  {
+    ScopedTiming DUNE_UNUSED(scopedTiming)("Allocations.Section");
+    std::vector<double> values(1000);
+    EXPECT_EQ(size_t(1000), values.size());
+  }
+  prof.disableAllocationTracking();
+  std::stringstream timings;
+  prof.outputTimings(timings);
+  if (available)
+    EXPECT_NE(timings.str().find("Allocations.Section_allocated_bytes"), std::string::npos);
+  else
+    EXPECT_EQ(timings.str().find("_allocated_bytes"), std::string::npos);
+}
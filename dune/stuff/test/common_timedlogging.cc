@@ -101,6 +101,25 @@ TEST(TimedLogger, fool_level_tracking)
   fool_level_tracking();
 }
 
+TEST(TimedLogger, disabled_output_is_not_evaluated)
+{
+  size_t evaluated = 0;
+  const auto evaluate = [&]() {
+    ++evaluated;
+    return "evaluated";
+  };
+  auto logger = TimedLogger().get("not_evaluated");
+  DSC_TIMED_LOG_INFO(logger) << "this info should be " << evaluate() << std::endl;
+  DSC_TIMED_LOG_WARN(logger) << "this warning should not be " << evaluate() << std::endl;
+  EXPECT_EQ(size_t(1), evaluated);
+  // the maximum debug level is 1
+  auto inner = TimedLogger().get("inner");
+  auto inner_inner = TimedLogger().get("inner_inner");
+  EXPECT_FALSE(inner_inner.debug_enabled());
+  DSC_TIMED_LOG_DEBUG(inner_inner) << "this debug should not be " << evaluate() << std::endl;
+  EXPECT_EQ(size_t(1), evaluated);
+}
+
 
 int main(int argc, char** argv)
 {
@@ -8,10 +8,15 @@
 #if HAVE_DUNE_GRID
 
 # include <dune/stuff/grid/walker.hh>
+# include <dune/stuff/grid/walker/static.hh>
 # include <dune/stuff/grid/provider/cube.hh>
 # include <dune/stuff/common/parallel/partitioner.hh>
 # include <dune/stuff/common/logstreams.hh>
 
+# include <cmath>
+# include <cstring>
+# include <numeric>
+
 # if DUNE_VERSION_NEWER(DUNE_COMMON,3,9) && HAVE_TBB // EXADUNE
 #   include <dune/grid/utility/partitioning/seedlist.hh>
 # endif
@@ -23,6 +28,134 @@ using namespace std;
 
 typedef testing::Types< Int<1>, Int<2>, Int<3> > GridDims;
 
+template< class GridViewType >
+struct CloneableCounter
+  : public Functor::Codim0And1< GridViewType >
+{
+  typedef Functor::Codim0And1< GridViewType > BaseType;
+  typedef typename BaseType::EntityType       EntityType;
+  typedef typename BaseType::IntersectionType IntersectionType;
+
+  CloneableCounter()
+    : entities(0)
+    , intersections(0)
+    , joins(0)
+  {}
+
+  virtual void apply_local(const EntityType&) override
+  {
+    ++entities;
+  }
+
+  virtual void apply_local(const IntersectionType&, const EntityType&, const EntityType&) override
+  {
+    ++intersections;
+  }
+
+  virtual std::unique_ptr< BaseType > clone() const override
+  {
+    return Dune::Stuff::Common::make_unique< CloneableCounter< GridViewType > >();
+  }
+
+  virtual void join(BaseType& other) override
+  {
+    const auto& other_counter = static_cast< CloneableCounter< GridViewType >& >(other);
+    entities += other_counter.entities;
+    intersections += other_counter.intersections;
+    ++joins;
+  }
+
+  size_t entities;
+  size_t intersections;
+  size_t joins;
+};
+
+//! sums volume times first center coordinate, exact on a cube grid so that any summation order gives the same bits
+template< class GridViewType >
+struct CloneableMoment
+  : public Functor::Codim0And1< GridViewType >
+{
+  typedef Functor::Codim0And1< GridViewType > BaseType;
+  typedef typename BaseType::EntityType       EntityType;
+
+  CloneableMoment()
+    : moment(0)
+  {}
+
+  //! spans several orders of magnitude and is not representable, so the rounding of a sum depends on its order
+  static double value(const EntityType& entity)
+  {
+    const auto geometry = entity.geometry();
+    double sum = 0;
+    for (const auto& coordinate : geometry.center())
+      sum += coordinate;
+    return std::exp(10. * sum) / 3. * geometry.volume();
+  }
+
+  virtual void apply_local(const EntityType& entity) override
+  {
+    moment += value(entity);
+  }
+
+  virtual std::unique_ptr< BaseType > clone() const override
+  {
+    return Dune::Stuff::Common::make_unique< CloneableMoment< GridViewType > >();
+  }
+
+  virtual void join(BaseType& other) override
+  {
+    moment += static_cast< CloneableMoment< GridViewType >& >(other).moment;
+  }
+
+  double moment;
+};
+
+//! counts its calls of apply_local(entity), does not provide worker copies, so all workers share it
+template< class GridViewType >
+struct CountingWalker
+  : public Walker< GridViewType >
+{
+  typedef Walker< GridViewType > BaseType;
+  typedef typename BaseType::EntityType EntityType;
+
+  CountingWalker(GridViewType grid_view, std::shared_ptr< atomic< size_t > > calls)
+    : BaseType(grid_view)
+    , calls_(calls)
+  {}
+
+  virtual void apply_local(const EntityType& entity) override
+  {
+    ++(*calls_);
+    BaseType::apply_local(entity);
+  }
+
+  using BaseType::apply_local;
+
+  std::shared_ptr< atomic< size_t > > calls_;
+};
+
+//! a CountingWalker whose workers get copies of their own type with cloned functors
+template< class GridViewType >
+struct CloningCountingWalker
+  : public CountingWalker< GridViewType >
+{
+  typedef CountingWalker< GridViewType > BaseType;
+
+  CloningCountingWalker(GridViewType grid_view, std::shared_ptr< atomic< size_t > > calls)
+    : BaseType(grid_view, calls)
+  {}
+
+protected:
+  virtual std::unique_ptr< Walker< GridViewType > >
+  worker_copy(Dune::Stuff::Grid::internal::Codim0And1Clones< GridViewType >& clones) override
+  {
+    auto copy = Dune::Stuff::Common::make_unique< CloningCountingWalker< GridViewType > >(this->grid_view(),
+                                                                                         this->calls_);
+    this->copy_functors_to(*copy, clones);
+    return std::move(copy);
+  }
+};
+
 template < class T >
 struct GridWalkerTest : public ::testing::Test
 {
@@ -54,6 +187,34 @@ struct GridWalkerTest : public ::testing::Test
                     walker.walk(partitioning);
                   };
     tests.push_back(test3);
+    auto test4 = [&]{
+                    IndexSetPartitioner<GridViewType> partitioner(gv.grid().leafIndexSet());
+                    ColoredPartitioner<GridViewType, IndexSetPartitioner<GridViewType>> coloring(gv, partitioner);
+                    EXPECT_GT(coloring.colors(), size_t(1));
+                    Dune::SeedListPartitioning<GridType, 0> partitioning(gv, coloring);
+                    walker.add(counter);
+                    walker.walk(partitioning, coloring);
+                  };
+    tests.push_back(test4);
+    auto test5 = [&]{
+                    SpaceFillingCurvePartitioner<GridViewType> partitioner(gv, 4 * threadManager().current_threads());
+                    Dune::SeedListPartitioning<GridType, 0> partitioning(gv, partitioner);
+                    walker.add(counter);
+                    walker.walk(partitioning);
+                  };
+    tests.push_back(test5);
+    auto test6 = [&]{
+                    walker.use_load_balancing();
+                    walker.add(counter);
+                    walker.walk(true);
+                    EXPECT_EQ(walker.entity_weights().size(), size_t(correct_size));
+                    // the second walk is cut by the measured weights
+                    count = 0;
+                    walker.add(counter);
+                    walker.walk(true);
+                    walker.use_load_balancing(false);
+                  };
+    tests.push_back(test6);
 # endif // DUNE_VERSION_NEWER(DUNE_COMMON,3,9) // EXADUNE
 
     for (const auto& test : tests) {
@@ -63,21 +224,148 @@ struct GridWalkerTest : public ::testing::Test
     }
   }
 
+  void check_space_filling_curve() {
+    const auto gv = grid_prv.grid().leafGridView();
+    const size_t num_entities = gv.size(0);
+    for (auto curve : {SpaceFillingCurve::hilbert, SpaceFillingCurve::morton}) {
+      SpaceFillingCurvePartitioner<GridViewType> partitioner(gv, 7, curve);
+      EXPECT_EQ(partitioner.partitions(), size_t(7));
+      vector<size_t> sizes(partitioner.partitions(), 0);
+      for (const auto& entity : DSC::entityRange(gv))
+        ++sizes[partitioner.partition(entity)];
+      const auto minmax = minmax_element(sizes.begin(), sizes.end());
+      EXPECT_LE(*minmax.second - *minmax.first, size_t(1));
+      // all weight on the first half of the entities
+      vector<double> weights(num_entities, 0.);
+      fill(weights.begin(), weights.begin() + num_entities / 2, 1.);
+      partitioner.cut(weights);
+      fill(sizes.begin(), sizes.end(), 0);
+      for (const auto& entity : DSC::entityRange(gv))
+        if (weights[gv.indexSet().index(entity)] > 0)
+          ++sizes[partitioner.partition(entity)];
+      const auto weighted_minmax = minmax_element(sizes.begin(), sizes.end());
+      EXPECT_LE(*weighted_minmax.second - *weighted_minmax.first, size_t(1));
+    }
+  }
+
   void check_apply_on() {
     const auto gv = grid_prv.grid().leafGridView();
     Walker<GridViewType> walker(gv);
 
-    size_t filter_count = 0, all_count = 0;
+    size_t filter_count = 0, all_count = 0, grouped_count = 0;
     auto boundaries = [=](const GridViewType&, const IntersectionType& inter){return inter.boundary();};
     auto filter_counter = [&](const IntersectionType&, const EntityType&, const EntityType&){filter_count++;};
     auto all_counter = [&](const IntersectionType&, const EntityType&, const EntityType&){all_count++;};
+    auto grouped_counter = [&](const IntersectionType&, const EntityType&, const EntityType&){grouped_count++;};
 
     auto on_filter_boundaries = new DSG::ApplyOn::FilteredIntersections<GridViewType>(boundaries);
     auto on_all_boundaries = new DSG::ApplyOn::BoundaryIntersections<GridViewType>();
+    auto on_grouped_boundaries = new DSG::ApplyOn::BoundaryIntersections<GridViewType>();
+    EXPECT_TRUE(on_all_boundaries->equivalent(*on_grouped_boundaries));
+    EXPECT_FALSE(on_all_boundaries->equivalent(*on_filter_boundaries));
     walker.add(filter_counter, on_filter_boundaries);
     walker.add(all_counter, on_all_boundaries);
+    walker.add(grouped_counter, on_grouped_boundaries);
     walker.walk();
     EXPECT_EQ(filter_count, all_count);
+    EXPECT_EQ(grouped_count, all_count);
+  }
+
+  void check_static() {
+    const auto gv = grid_prv.grid().leafGridView();
+    CloneableCounter<GridViewType> counter;
+    CloneableCounter<GridViewType> reference;
+    size_t boundary_count = 0, reference_boundary_count = 0;
+    auto walker = make_static_walker(gv,
+                                     on_entities_and_intersections(counter),
+                                     on_intersections([&](const IntersectionType&, const EntityType&, const EntityType&)
+                                                      { ++boundary_count; },
+                                                      DSG::ApplyOn::BoundaryIntersections<GridViewType>()));
+    walker.walk();
+    Walker<GridViewType> dynamic_walker(gv);
+    dynamic_walker.add(reference);
+    dynamic_walker.add([&](const IntersectionType&, const EntityType&, const EntityType&){ ++reference_boundary_count; },
+                       new DSG::ApplyOn::BoundaryIntersections<GridViewType>());
+    dynamic_walker.walk();
+    EXPECT_EQ(counter.entities, reference.entities);
+    EXPECT_EQ(counter.intersections, reference.intersections);
+    EXPECT_EQ(boundary_count, reference_boundary_count);
+  }
+
+  void check_clones() {
+    const auto gv = grid_prv.grid().leafGridView();
+    size_t correct_intersections = 0;
+    for (const auto& entity : DSC::entityRange(gv))
+      correct_intersections += entity.template count< 1 >();
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridViewType> walker(gv);
+      CloneableCounter<GridViewType> counter;
+      walker.add(counter);
+      walker.walk(use_tbb);
+      EXPECT_EQ(counter.entities, size_t(gv.size(0)));
+      EXPECT_EQ(counter.intersections, correct_intersections);
+    }
+  }
+
+  void check_derived_walkers() {
+    const auto gv = grid_prv.grid().leafGridView();
+    const size_t num_entities = gv.size(0);
+    CloneableMoment<GridViewType> serial;
+    Walker<GridViewType> serial_walker(gv);
+    serial_walker.add(serial);
+    serial_walker.walk(false);
+    // a derived walker without worker copies shares its functors, so only thread-safe ones may be added
+    {
+      auto calls = make_shared<atomic<size_t>>(0);
+      atomic<size_t> count(0);
+      CountingWalker<GridViewType> walker(gv, calls);
+      walker.add([&](const EntityType&){ ++count; });
+      walker.walk(true);
+      EXPECT_EQ(num_entities, calls->load());
+      EXPECT_EQ(num_entities, count.load());
+    }
+    // the overridden apply_local() is also used by the worker copies
+    for (const bool use_tbb : {false, true}) {
+      auto calls = make_shared<atomic<size_t>>(0);
+      CloneableMoment<GridViewType> moment;
+      CloningCountingWalker<GridViewType> walker(gv, calls);
+      walker.add(moment);
+      walker.walk(use_tbb);
+      EXPECT_EQ(num_entities, calls->load());
+      EXPECT_DOUBLE_EQ(serial.moment, moment.moment);
+    }
+  }
+
+  void check_deterministic_join() {
+# if DUNE_VERSION_NEWER(DUNE_COMMON,3,9) && HAVE_TBB // EXADUNE
+    const DSG::Providers::Cube<GridType> fine_prv(0.f, 1.f, 16);
+    const auto gv = fine_prv.grid().leafGridView();
+    // the test is only meaningful if the order of the summation matters
+    vector<double> values;
+    for (const auto& entity : DSC::entityRange(gv))
+      values.push_back(CloneableMoment<GridViewType>::value(entity));
+    const double forward = accumulate(values.begin(), values.end(), 0.);
+    const double backward = accumulate(values.rbegin(), values.rend(), 0.);
+    EXPECT_NE(0, std::memcmp(&forward, &backward, sizeof(double)));
+    // the partial results are joined in the same order for any number of threads
+    auto& manager = threadManager();
+    const auto max_threads = manager.max_threads();
+    vector<double> moments;
+    for (const size_t threads : {size_t(1), size_t(2), size_t(4)}) {
+      manager.set_max_threads(threads);
+      for (size_t run = 0; run < 2; ++run) {
+        RangedPartitioning<GridViewType, 0> partitioning(gv, 16);
+        CloneableMoment<GridViewType> moment;
+        Walker<GridViewType> walker(gv);
+        walker.add(moment);
+        walker.walk(partitioning);
+        moments.push_back(moment.moment);
+      }
+    }
+    manager.set_max_threads(max_threads);
+    for (const auto& moment : moments)
+      EXPECT_EQ(0, std::memcmp(&moments.front(), &moment, sizeof(double)));
+# endif // DUNE_VERSION_NEWER(DUNE_COMMON,3,9) && HAVE_TBB // EXADUNE
   }
 };
 
@@ -85,6 +373,11 @@ TYPED_TEST_CASE(GridWalkerTest, GridDims);
 TYPED_TEST(GridWalkerTest, Misc) {
   this->check_count();
   this->check_apply_on();
+  this->check_space_filling_curve();
+  this->check_clones();
+  this->check_derived_walkers();
+  this->check_deterministic_join();
+  this->check_static();
 }
 
 
@@ -52,6 +52,10 @@ typedef testing::Types<
                                  , Dune::Stuff::LA::CommonDenseVector< double > >
                       , std::pair< Dune::Stuff::LA::CommonDenseMatrix< std::complex< double > >
                                  , Dune::Stuff::LA::CommonDenseVector< std::complex< double > > >
+                      , std::pair< Dune::Stuff::LA::CommonSparseMatrixCsr< double >
+                                 , Dune::Stuff::LA::CommonDenseVector< double > >
+                      , std::pair< Dune::Stuff::LA::CommonSparseMatrixCsr< std::complex< double > >
+                                 , Dune::Stuff::LA::CommonDenseVector< std::complex< double > > >
 #if HAVE_EIGEN
                       , std::pair< Dune::Stuff::LA::EigenRowMajorSparseMatrix< double >
                                  , Dune::Stuff::LA::EigenDenseVector< double > >
@@ -83,6 +87,8 @@ typedef testing::Types<
                       , Dune::Stuff::LA::CommonDenseMatrix< double >
                       , Dune::Stuff::LA::CommonDenseVector< std::complex< double > >
                       , Dune::Stuff::LA::CommonDenseMatrix< std::complex< double > >
+                      , Dune::Stuff::LA::CommonSparseMatrixCsr< double >
+                      , Dune::Stuff::LA::CommonSparseMatrixCsr< std::complex< double > >
 #if HAVE_EIGEN
                       , Dune::Stuff::LA::EigenDenseVector< double >
                       , Dune::Stuff::LA::EigenMappedDenseVector< double >
@@ -137,6 +143,10 @@ struct ContainerTest
     ContainerImp d_by_size = ContainerFactory< ContainerImp >::create(dim);
     ContainerImp d_copy_constructor(d_by_size);
     ContainerImp DUNE_UNUSED(d_copy_assignment) = d_by_size;
+    const ContainerImp& d_const_by_size = d_by_size;
+    const ContainerImp& d_const_copy = d_copy_constructor;
+    EXPECT_EQ(&d_const_by_size.backend(), &d_const_copy.backend()) << "check copy-on-write";
+    check_data_access(d_by_size, std::is_base_of< Stuff::LA::Tags::ProvidesDataAccess, ContainerImp >());
     ContainerImp d_deep_copy = d_by_size.copy();
     d_by_size.scal(D_ScalarType(1));
     d_by_size.axpy(D_ScalarType(1), d_deep_copy);
@@ -147,6 +157,25 @@ struct ContainerTest
     i_by_size.scal(I_ScalarType(1));
     i_by_size.axpy(I_ScalarType(1), i_deep_copy);
   } //void fulfills_interface() const
+
+  static void check_data_access(ContainerImp& container, std::true_type)
+  {
+    typedef typename ContainerImp::ScalarType ScalarType;
+    ContainerImp copy(container);
+    const ContainerImp& const_container = container;
+    const ContainerImp& const_copy = copy;
+    EXPECT_EQ(const_container.data(), const_copy.data()) << "check copy-on-write";
+    const ScalarType original = const_container.data()[0];
+    Stuff::LA::MutableDataView< ContainerImp > view(copy);
+    EXPECT_NE(const_container.data(), view.data()) << "check copy-on-write";
+    EXPECT_EQ(const_copy.data(), view.data());
+    view[0] = original + ScalarType(1);
+    EXPECT_EQ(original, const_container.data()[0]) << "check copy-on-write";
+    EXPECT_EQ(original + ScalarType(1), const_copy.data()[0]);
+  } // ... check_data_access(...)
+
+  static void check_data_access(ContainerImp& /*container*/, std::false_type)
+  {}
 }; // struct ContainerTest
 
 
@@ -660,6 +689,114 @@ struct VectorTest
     for (size_t ii = 0; ii < dim; ++ii) {
       EXPECT_TRUE(DSC::FloatCmp::eq(ScalarType(1), ones[ii])) << "check copy-on-write";
     }
+
+    //test expression templates
+    VectorImp expression_result = testvector_1 + ScalarType(2)*testvector_3 - countingup*ScalarType(0.5);
+    VectorImp expression_correct = testvector_1;
+    expression_correct.axpy(ScalarType(2), testvector_3);
+    expression_correct.axpy(ScalarType(-0.5), countingup);
+    EXPECT_EQ(expression_correct, expression_result);
+    expression_result = ones;
+    expression_result += ScalarType(0.25)*(testvector_5 - testvector_2);
+    expression_correct = ones;
+    expression_correct.axpy(ScalarType(0.25), testvector_5);
+    expression_correct.axpy(ScalarType(-0.25), testvector_2);
+    EXPECT_EQ(expression_correct, expression_result);
+    expression_result -= -(testvector_4 + testvector_4);
+    expression_correct.axpy(ScalarType(2), testvector_4);
+    EXPECT_EQ(expression_correct, expression_result);
+    expression_result.assign(expression_result - testvector_3);
+    expression_correct -= testvector_3;
+    EXPECT_EQ(expression_correct, expression_result);
+    a = ones;
+    a = ones + testvector_3;
+    for (size_t ii = 0; ii < dim; ++ii) {
+      EXPECT_TRUE(DSC::FloatCmp::eq(ScalarType(1), ones[ii])) << "check copy-on-write";
+    }
+    VectorImp too_large(dim + 1);
+    EXPECT_THROW(ones + too_large, Stuff::Exceptions::shapes_do_not_match);
+    EXPECT_THROW(too_large.assign(ones - testvector_1), Stuff::Exceptions::shapes_do_not_match);
+
+    //test large vectors with a size which is not a multiple of any vector width (all sums are exact)
+    const size_t large_dim = 1001;
+    VectorImp large_x(large_dim);
+    VectorImp large_y(large_dim);
+    RealType correct_dot(0);
+    RealType correct_l1_norm(0);
+    RealType correct_l2_norm_squared(0);
+    for (size_t ii = 0; ii < large_dim; ++ii) {
+      large_x.set_entry(ii, ScalarType(double(ii % 7) - 3.0));
+      large_y.set_entry(ii, ScalarType(0.5 * double(ii % 5)));
+      correct_dot += (double(ii % 7) - 3.0) * 0.5 * double(ii % 5);
+      correct_l1_norm += std::abs(double(ii % 7) - 3.0);
+      correct_l2_norm_squared += (double(ii % 7) - 3.0) * (double(ii % 7) - 3.0);
+    }
+    EXPECT_DOUBLE_OR_COMPLEX_EQ(correct_dot, large_x.dot(large_y));
+    EXPECT_DOUBLE_EQ(correct_l1_norm, large_x.l1_norm());
+    EXPECT_DOUBLE_EQ(std::sqrt(correct_l2_norm_squared), large_x.l2_norm());
+    EXPECT_DOUBLE_EQ(RealType(3), large_x.sup_norm());
+    VectorImp large_result(large_dim);
+    large_x.add(large_y, large_result);
+    for (size_t ii = 0; ii < large_dim; ++ii)
+      EXPECT_EQ(large_x.get_entry(ii) + large_y.get_entry(ii), large_result.get_entry(ii));
+    large_x.sub(large_y, large_result);
+    for (size_t ii = 0; ii < large_dim; ++ii)
+      EXPECT_EQ(large_x.get_entry(ii) - large_y.get_entry(ii), large_result.get_entry(ii));
+    large_result = large_y;
+    large_result.axpy(ScalarType(-0.5), large_x);
+    for (size_t ii = 0; ii < large_dim; ++ii)
+      EXPECT_EQ(large_y.get_entry(ii) + ScalarType(-0.5) * large_x.get_entry(ii), large_result.get_entry(ii));
+
+    //test vectors which are processed in several chunks, in parallel if enabled (all sums are exact)
+    const size_t huge_dim = std::max(size_t(DUNE_STUFF_LA_PARALLEL_THRESHOLD),
+                                     3 * Stuff::LA::internal::vector_chunk_size) + 7;
+    VectorImp huge_x(huge_dim);
+    VectorImp huge_y(huge_dim, ScalarType(0.5));
+    RealType huge_sum(0);
+    RealType huge_l1_norm(0);
+    RealType huge_l2_norm_squared(0);
+    for (size_t ii = 0; ii < huge_dim; ++ii) {
+      const RealType value = (ii == huge_dim - 2) ? -4.0 : double(ii % 7) - 3.0;
+      huge_x.set_entry(ii, ScalarType(value));
+      huge_sum += value;
+      huge_l1_norm += std::abs(value);
+      huge_l2_norm_squared += value * value;
+    }
+    EXPECT_DOUBLE_OR_COMPLEX_EQ(0.5 * huge_sum, huge_x.dot(huge_y));
+    EXPECT_DOUBLE_EQ(huge_l1_norm, huge_x.l1_norm());
+    EXPECT_DOUBLE_EQ(std::sqrt(huge_l2_norm_squared), huge_x.l2_norm());
+    EXPECT_DOUBLE_EQ(RealType(4), huge_x.sup_norm());
+    EXPECT_EQ(huge_dim - 2, huge_x.amax().first);
+    EXPECT_DOUBLE_OR_COMPLEX_EQ(huge_sum / huge_dim, huge_x.mean());
+    const ScalarType huge_mean = huge_x.mean();
+    RealType huge_variance(0);
+    for (size_t ii = 0; ii < huge_dim; ++ii)
+      huge_variance += std::pow(std::real(huge_x.get_entry(ii) - huge_mean), 2);
+    EXPECT_NEAR(std::sqrt(huge_variance / huge_dim), std::real(huge_x.standard_deviation()), 1e-12);
+    VectorImp huge_result = huge_y;
+    huge_result.axpy(ScalarType(2), huge_x);
+    huge_result.scal(ScalarType(0.5));
+    huge_result += huge_x;
+    huge_result -= huge_y;
+    size_t wrong_entries = 0;
+    for (size_t ii = 0; ii < huge_dim; ++ii)
+      if (huge_result.get_entry(ii) != (ScalarType(0.5) + ScalarType(2) * huge_x.get_entry(ii)) * ScalarType(0.5)
+                                      + huge_x.get_entry(ii) - ScalarType(0.5))
+        ++wrong_entries;
+    EXPECT_EQ(size_t(0), wrong_entries);
+#if HAVE_TBB
+    // the reductions do not depend on the number of threads
+    for (size_t ii = 0; ii < huge_dim; ++ii)
+      huge_y.set_entry(ii, ScalarType(1.0 / double(ii + 1)));
+    const size_t max_threads = Stuff::threadManager().max_threads();
+    Stuff::threadManager().set_max_threads(std::max(size_t(2), max_threads));
+    const ScalarType parallel_dot = huge_x.dot(huge_y);
+    const RealType parallel_l2_norm = huge_y.l2_norm();
+    Stuff::threadManager().set_max_threads(1);
+    EXPECT_EQ(parallel_dot, huge_x.dot(huge_y));
+    EXPECT_EQ(parallel_l2_norm, huge_y.l2_norm());
+    Stuff::threadManager().set_max_threads(max_threads);
+#endif // HAVE_TBB
   } //void produces_correct_results() const
 }; // struct VectorTest
 
@@ -983,3 +1120,61 @@ TYPED_TEST(MatrixTest, produces_correct_results) {
   this->produces_correct_results();
 }
 
+
+
+TEST(CommonSparseMatrixCsr, produces_correct_results_for_large_matrices)
+{
+  typedef Stuff::LA::CommonSparseMatrixCsr< double > MatrixType;
+  typedef Stuff::LA::CommonDenseVector< double >     VectorType;
+  // large enough to be processed in several blocks (in parallel, if enabled), every tenth row is empty and row 3 spans
+  // several blocks (all sums are exact)
+  const size_t size = std::max(size_t(DUNE_STUFF_LA_PARALLEL_THRESHOLD),
+                               3 * Stuff::LA::internal::vector_chunk_size) + 7;
+  Stuff::LA::SparsityPatternDefault pattern(size);
+  for (size_t ii = 0; ii < size; ++ii)
+    if (ii % 10 != 9)
+      for (size_t jj = (ii > 0 ? ii - 1 : 0); jj < std::min(size, ii + 2); ++jj)
+        pattern.inner(ii).push_back(jj);
+  pattern.inner(3).clear();
+  for (size_t jj = 0; jj < 2 * Stuff::LA::internal::vector_chunk_size + 3; ++jj)
+    pattern.inner(3).push_back(jj);
+  MatrixType matrix(size, size, pattern);
+  size_t non_zeros = 0;
+  for (size_t ii = 0; ii < size; ++ii) {
+    for (const size_t& jj : pattern.inner(ii))
+      matrix.set_entry(ii, jj, double((ii + 2 * jj) % 5) - 2.0);
+    non_zeros += pattern.inner(ii).size();
+  }
+  EXPECT_EQ(non_zeros, matrix.non_zeros());
+  EXPECT_EQ(pattern, matrix.pattern());
+  EXPECT_DOUBLE_EQ(2.0, matrix.sup_norm());
+  VectorType xx(size);
+  for (size_t jj = 0; jj < size; ++jj)
+    xx.set_entry(jj, double(jj % 3) - 1.0);
+  VectorType yy(size, 1.0);
+  matrix.mv(xx, yy);
+  size_t wrong_entries = 0;
+  for (size_t ii = 0; ii < size; ++ii) {
+    double expected = 0;
+    for (const size_t& jj : pattern.inner(ii))
+      expected += (double((ii + 2 * jj) % 5) - 2.0) * xx.get_entry(jj);
+    if (yy.get_entry(ii) != expected)
+      ++wrong_entries;
+  }
+  EXPECT_EQ(size_t(0), wrong_entries);
+  VectorType zz = xx;
+  matrix.mv(zz, zz);
+  EXPECT_EQ(yy, zz);
+#if HAVE_TBB
+  // the result does not depend on the number of threads
+  const size_t max_threads = Stuff::threadManager().max_threads();
+  Stuff::threadManager().set_max_threads(std::max(size_t(2), max_threads));
+  matrix.mv(xx, zz);
+  Stuff::threadManager().set_max_threads(max_threads);
+  EXPECT_EQ(yy, zz);
+#endif // HAVE_TBB
+  EXPECT_THROW(matrix.set_entry(9, 9, 1.0), Stuff::Exceptions::index_out_of_range);
+  EXPECT_THROW(matrix.unit_row(9), Stuff::Exceptions::index_out_of_range);
+  VectorType too_large(size + 1);
+  EXPECT_THROW(matrix.mv(xx, too_large), Stuff::Exceptions::shapes_do_not_match);
+}
@@ -42,6 +42,22 @@ public:
   }
 };
 
+template< class S >
+class ContainerFactory< Dune::Stuff::LA::CommonSparseMatrixCsr< S > >
+{
+public:
+  static Dune::Stuff::LA::CommonSparseMatrixCsr< S > create(const size_t size)
+  {
+    Dune::Stuff::LA::SparsityPatternDefault pattern(size);
+    for (size_t ii = 0; ii < size; ++ii)
+      pattern.inner(ii).push_back(ii);
+    Dune::Stuff::LA::CommonSparseMatrixCsr< S > matrix(size, size, pattern);
+    for (size_t ii = 0; ii < size; ++ii)
+      matrix.unit_row(ii);
+    return matrix;
+  }
+};
+
 
 #if HAVE_DUNE_ISTL
 template< class S >